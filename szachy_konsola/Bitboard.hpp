@@ -0,0 +1,113 @@
+﻿#pragma once
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Reprezentacja 32 ciemnych pól planszy 8x8.
+// Bit i to pole (row = i / 4, col = 2 * (i % 4) + (row parzysty ? 1 : 0)),
+// czyli kolejność wierszami, tak jak w dawnym std::vector<Piece>.
+using Bitboard = uint32_t;
+
+namespace bb {
+
+    constexpr int SQUARES = 32;
+
+    constexpr Bitboard ALL = 0xFFFFFFFFu;
+    constexpr Bitboard EVEN_ROWS = 0x0F0F0F0Fu; // wiersze 0, 2, 4, 6 (ciemne pola w kolumnach nieparzystych)
+    constexpr Bitboard ODD_ROWS = 0xF0F0F0F0u;  // wiersze 1, 3, 5, 7 (ciemne pola w kolumnach parzystych)
+    constexpr Bitboard LEFT_FILE = 0x11111111u;  // pierwsze ciemne pole w wierszu
+    constexpr Bitboard RIGHT_FILE = 0x88888888u; // ostatnie ciemne pole w wierszu
+    constexpr Bitboard ROW_0 = 0x0000000Fu;      // promocja białych
+    constexpr Bitboard ROW_7 = 0xF0000000u;      // promocja czarnych
+
+    constexpr int square(int row, int col) {
+        if (row < 0 || row >= 8 || col < 0 || col >= 8 || (row + col) % 2 == 0) return -1;
+        return row * 4 + col / 2;
+    }
+
+    constexpr int row(int sq) { return sq / 4; }
+    constexpr int col(int sq) { return 2 * (sq % 4) + ((sq / 4) % 2 == 0 ? 1 : 0); }
+
+    constexpr Bitboard bit(int sq) { return Bitboard(1) << sq; }
+
+    // Przesunięcia o jedno pole po przekątnej; bity wychodzące poza planszę znikają.
+    // "up" = w stronę wiersza 0 (kierunek białych), "down" = w stronę wiersza 7.
+    constexpr Bitboard upLeft(Bitboard b) {
+        return ((b & EVEN_ROWS) >> 4) | ((b & ODD_ROWS & ~LEFT_FILE) >> 5);
+    }
+    constexpr Bitboard upRight(Bitboard b) {
+        return ((b & EVEN_ROWS & ~RIGHT_FILE) >> 3) | ((b & ODD_ROWS) >> 4);
+    }
+    constexpr Bitboard downLeft(Bitboard b) {
+        return ((b & EVEN_ROWS) << 4) | ((b & ODD_ROWS & ~LEFT_FILE) << 3);
+    }
+    constexpr Bitboard downRight(Bitboard b) {
+        return ((b & EVEN_ROWS & ~RIGHT_FILE) << 5) | ((b & ODD_ROWS) << 4);
+    }
+
+    enum Direction { UP_LEFT, UP_RIGHT, DOWN_LEFT, DOWN_RIGHT };
+
+    constexpr Bitboard shift(Bitboard b, int dir) {
+        switch (dir) {
+        case UP_LEFT: return upLeft(b);
+        case UP_RIGHT: return upRight(b);
+        case DOWN_LEFT: return downLeft(b);
+        default: return downRight(b);
+        }
+    }
+
+    // kierunek przeciwny (UP_LEFT <-> DOWN_RIGHT, UP_RIGHT <-> DOWN_LEFT)
+    constexpr int opposite(int dir) { return 3 - dir; }
+
+    // piony ruszają się i biją tylko do przodu: białe w górę, czarne w dół
+    constexpr bool isForward(int dir, bool white) { return white ? dir <= UP_RIGHT : dir >= DOWN_LEFT; }
+
+    inline int popCount(Bitboard b) {
+#ifdef _MSC_VER
+        return static_cast<int>(__popcnt(b));
+#else
+        return __builtin_popcount(b);
+#endif
+    }
+
+    // indeks najmłodszego ustawionego bitu, b != 0
+    inline int lsb(Bitboard b) {
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanForward(&idx, b);
+        return static_cast<int>(idx);
+#else
+        return __builtin_ctz(b);
+#endif
+    }
+
+    inline int popLsb(Bitboard& b) {
+        int sq = lsb(b);
+        b &= b - 1;
+        return sq;
+    }
+}
+
+// Stan planszy: białe, czarne i damki (damki to podzbiór białych | czarnych).
+struct Position {
+    Bitboard white = 0;
+    Bitboard black = 0;
+    Bitboard kings = 0;
+
+    Bitboard occupied() const { return white | black; }
+    Bitboard empty() const { return ~(white | black); }
+    Bitboard pieces(bool whiteSide) const { return whiteSide ? white : black; }
+
+    // figury strony, które mogą iść w kierunku dir (damki zawsze, piony tylko do przodu)
+    Bitboard movers(bool whiteSide, int dir) const {
+        Bitboard own = pieces(whiteSide);
+        return bb::isForward(dir, whiteSide) ? own : (own & kings);
+    }
+
+    // pola lądowania bić w kierunku dir dla figur z maski from
+    Bitboard jumpTargets(Bitboard from, bool whiteSide, int dir) const {
+        return bb::shift(bb::shift(from, dir) & pieces(!whiteSide), dir) & empty();
+    }
+};
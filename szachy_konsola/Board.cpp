@@ -1,71 +1,114 @@
-#include "Board.hpp"
+﻿#include "Board.hpp"
+#include "SearchService.hpp"
+#include "Scenarios.hpp"
+#include "Notation.hpp"
+#include "Book.hpp"
+#include "Stats.hpp"
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <cmath>
 #include <optional>
+#include <cassert>
+#include <algorithm>
+#include <random>
+#include <chrono>
 #include <SFML/Graphics.hpp>
 
 
-Board::Board() {
-    board.resize(SIZE * SIZE, EMPTY);
-    for (int i = 0; i < 3; ++i)
-        for (int j = 0; j < SIZE; ++j)
-            if ((i + j) % 2 == 1)
-                set(i, j, BLACK);
+namespace {
+    std::string pvText(const GameState& root, bool whiteTurn, const std::vector<Move>& pv) {
+        constexpr size_t MAX_SHOWN = 8; // dłuższa linia nie mieści się w oknie
+        std::string text;
+        GameState s = root;
+        for (size_t i = 0; i < pv.size() && i < MAX_SHOWN; ++i) {
+            text += (i ? " " : "") + notation::moveToString(s, whiteTurn, pv[i]);
+            s.applyMove(pv[i], whiteTurn);
+            whiteTurn = !whiteTurn;
+        }
+        return text;
+    }
 
-    for (int i = 5; i < SIZE; ++i)
-        for (int j = 0; j < SIZE; ++j)
-            if ((i + j) % 2 == 1)
-                set(i, j, WHITE);
-}
+    uint64_t perSecond(uint64_t count, int64_t ms) { return ms > 0 ? count * 1000 / uint64_t(ms) : 0; }
 
+    int percent(uint64_t part, uint64_t total) { return total ? int(100 * part / total) : 0; }
 
-void Board::draw(sf::RenderWindow& window) const {
-    constexpr int TILE_SIZE = 80;
-    sf::RectangleShape tile(sf::Vector2f(TILE_SIZE, TILE_SIZE));
-    sf::CircleShape piece(TILE_SIZE / 2 - 10);
+    // Siatki rysowane jednym wywołaniem draw: każdy kwadrat i koło to trójkąty w tej samej tablicy
+    void appendQuad(sf::VertexArray& mesh, sf::Vector2f corner, float size, sf::Color color) {
+        sf::Vector2f a = corner, b(corner.x + size, corner.y), c(corner.x + size, corner.y + size), d(corner.x, corner.y + size);
+        for (sf::Vector2f p : { a, b, c, a, c, d })
+            mesh.append(sf::Vertex{ p, color, {} });
+    }
+
+    void appendCircle(sf::VertexArray& mesh, sf::Vector2f center, float radius, sf::Color color) {
+        constexpr int SEGMENTS = 30; // jak domyślny sf::CircleShape
+        constexpr float STEP = 2 * 3.14159265f / SEGMENTS;
+        for (int i = 0; i < SEGMENTS; ++i) {
+            sf::Vector2f p1(center.x + radius * std::cos(i * STEP), center.y + radius * std::sin(i * STEP));
+            sf::Vector2f p2(center.x + radius * std::cos((i + 1) * STEP), center.y + radius * std::sin((i + 1) * STEP));
+            mesh.append(sf::Vertex{ center, color, {} });
+            mesh.append(sf::Vertex{ p1, color, {} });
+            mesh.append(sf::Vertex{ p2, color, {} });
+        }
+    }
+}
+
+Board::Board() : tiles(sf::PrimitiveType::Triangles), pieces(sf::PrimitiveType::Triangles) {
+    scenario::startPosition(state);
 
     sf::Color light(232, 235, 239);
     sf::Color dark(125, 135, 150);
+    for (int row = 0; row < SIZE; ++row)
+        for (int col = 0; col < SIZE; ++col)
+            appendQuad(tiles, sf::Vector2f(col * TILE_SIZE, row * TILE_SIZE), TILE_SIZE, (row + col) % 2 == 0 ? light : dark);
+}
+
+
+
+void Board::rebuildPieces() const {
+    pieces.clear();
 
     for (int row = 0; row < SIZE; ++row) {
         for (int col = 0; col < SIZE; ++col) {
-            tile.setPosition(sf::Vector2f(col * TILE_SIZE, row * TILE_SIZE));
-            tile.setFillColor((row + col) % 2 == 0 ? light : dark);
-            window.draw(tile);
-
             Piece p = get(row, col);
             if (p == EMPTY) continue;
 
-            piece.setPosition(sf::Vector2f(col * TILE_SIZE + 10, row * TILE_SIZE + 10));
-            piece.setFillColor((p == WHITE || p == WHITE_KING) ? sf::Color::White : sf::Color::Black);
-            window.draw(piece);
+            sf::Vector2f center(col * TILE_SIZE + TILE_SIZE / 2, row * TILE_SIZE + TILE_SIZE / 2);
+            appendCircle(pieces, center, TILE_SIZE / 2 - 10, (p == WHITE || p == WHITE_KING) ? sf::Color::White : sf::Color::Black);
 
-            // rysowanie "korony"
-            if (p == WHITE_KING || p == BLACK_KING) {
-                sf::CircleShape crown(TILE_SIZE / 2 - 25);
-                crown.setPosition(sf::Vector2f(col * TILE_SIZE + 25, row * TILE_SIZE + 25));
-                crown.setFillColor(sf::Color(255, 215, 0)); // zoty kolor
-                window.draw(crown);
-            }
+            // "korona" damki
+            if (p == WHITE_KING || p == BLACK_KING)
+                appendCircle(pieces, center, TILE_SIZE / 2 - 25, sf::Color(255, 215, 0)); // złoty kolor
         }
     }
 
-    // Rysuj zaznaczone pole (jeli jakie jest)
-    if (selectedRow != -1 && selectedCol != -1) {
-        sf::RectangleShape highlight(sf::Vector2f(TILE_SIZE, TILE_SIZE));
-        highlight.setPosition(sf::Vector2f(selectedCol * TILE_SIZE, selectedRow * TILE_SIZE));
-        highlight.setFillColor(sf::Color(255, 255, 0, 100));  // pprzezroczysty ty
-        window.draw(highlight);
+    // Zaznaczone pole (jeśli jakieś jest) i możliwe ruchy - półprzezroczyste, na figurach
+    if (selectedRow != -1 && selectedCol != -1)
+        appendQuad(pieces, sf::Vector2f(selectedCol * TILE_SIZE, selectedRow * TILE_SIZE), TILE_SIZE, sf::Color(255, 255, 0, 100));
+    for (const auto& move : possibleMoves)
+        appendQuad(pieces, sf::Vector2f(move.second * TILE_SIZE, move.first * TILE_SIZE), TILE_SIZE, sf::Color(0, 255, 0, 100));
+}
+
+void Board::draw(sf::RenderWindow& window) const {
+    if (dirty) {
+        rebuildPieces();
+        dirty = false;
     }
-    // zaznacz moliwe ruchy
-    for (const auto& move : possibleMoves) {
-        sf::RectangleShape hint(sf::Vector2f(TILE_SIZE, TILE_SIZE));
-        hint.setPosition(sf::Vector2f(move.second * TILE_SIZE, move.first * TILE_SIZE));
-        hint.setFillColor(sf::Color(0, 255, 0, 100)); // zielony pprzezroczysty
-        window.draw(hint);
+    window.draw(tiles);
+    window.draw(pieces);
+
+    if (showStats && hasStatsFont && !statsText.empty()) {
+        sf::Text text(statsFont, statsText, 14);
+        text.setFillColor(sf::Color::White);
+        text.setPosition(sf::Vector2f(10, 10));
+
+        sf::FloatRect bounds = text.getGlobalBounds();
+        sf::RectangleShape box(sf::Vector2f(bounds.size.x + 16, bounds.size.y + 16));
+        box.setPosition(sf::Vector2f(bounds.position.x - 8, bounds.position.y - 8));
+        box.setFillColor(sf::Color(0, 0, 0, 170)); // półprzezroczyste tło pod tekstem
+        window.draw(box);
+        window.draw(text);
     }
-
 }
 
 
@@ -79,58 +122,45 @@ std::string Board::pieceToStr(Piece p) const {
     }
 }
 
-bool Board::isInside(int x, int y) const {
-    return x >= 0 && x < SIZE && y >= 0 && y < SIZE;
-}
-
 bool Board::isPlayerPiece(Piece p, bool whiteTurn) const {
     if (whiteTurn) return p == WHITE || p == WHITE_KING;
     return p == BLACK || p == BLACK_KING;
 }
 
 Board::Piece Board::get(int x, int y) const {
-    return board[x * SIZE + y];
+    int sq = bb::square(x, y);
+    if (sq < 0) return EMPTY; // jasne pola są zawsze puste
+
+    const Position& pos = state.pos;
+    Bitboard b = bb::bit(sq);
+    bool isKing = (pos.kings & b) != 0;
+    if (pos.white & b) return isKing ? WHITE_KING : WHITE;
+    if (pos.black & b) return isKing ? BLACK_KING : BLACK;
+    return EMPTY;
 }
 
 void Board::set(int x, int y, Piece value) {
-    board[x * SIZE + y] = value;
+    int sq = bb::square(x, y);
+    assert(sq >= 0 && "figury stoją tylko na ciemnych polach");
+    if (sq < 0) return;
+
+    dirty = true;
+    if (value == EMPTY)
+        state.removePiece(sq);
+    else
+        state.putPiece(sq, value == WHITE || value == WHITE_KING, value == WHITE_KING || value == BLACK_KING);
 }
 
-bool Board::isValidMove(int x1, int y1, int x2, int y2, bool whiteTurn, bool& isCapture) const {
-    if (!isInside(x1, y1) || !isInside(x2, y2)) return false;
-    Piece p = get(x1, y1);
-    Piece target = get(x2, y2);
-    if (target != EMPTY) return false;
-
-    int dx = x2 - x1;
-    int dy = y2 - y1;
-
-    // Zwyky ruch o jedno pole
-    if (std::abs(dx) == 1 && std::abs(dy) == 1) {
-        if (inCombo) return false; // nie mona wykona zwykego ruchu w trakcie kombinacji
-        if (hasCapture(whiteTurn)) return false; // nie mona wykona zwykego ruchu jeeli jest bicie 
-        if ((p == WHITE && dx == -1) || (p == BLACK && dx == 1)) return true;
-        if (p == WHITE_KING || p == BLACK_KING) return true;
-    }
 
-    // Bicie
-    if (std::abs(dx) == 2 && std::abs(dy) == 2) {
-        int mx = x1 + dx / 2;
-        int my = y1 + dy / 2;
-        Piece mid = get(mx, my);
-        if (mid != EMPTY && !isPlayerPiece(mid, whiteTurn)) {
-            if ((p == WHITE && dx == -2) || (p == BLACK && dx == 2)) {
-                isCapture = true;
-                return true;
-            }
-            if (p == WHITE_KING || p == BLACK_KING) {
-                isCapture = true;
-                return true;
-            }
-        }
-    }
 
-    return false;
+
+bool Board::isValidMove(int x1, int y1, int x2, int y2, bool whiteTurn, bool& isCapture) const {
+    int from = bb::square(x1, y1), to = bb::square(x2, y2); // -1 poza planszą i na jasnych polach
+    if (from < 0 || to < 0 || !isPlayerPiece(get(x1, y1), whiteTurn)) return false;
+    if (!(state.targetsFrom(from, whiteTurn, inCombo) & bb::bit(to))) return false;
+
+    isCapture = std::abs(x2 - x1) == 2;
+    return true;
 }
 
 bool Board::movePiece(int x1, int y1, int x2, int y2, bool whiteTurn) {
@@ -140,7 +170,7 @@ bool Board::movePiece(int x1, int y1, int x2, int y2, bool whiteTurn) {
     set(x2, y2, get(x1, y1));
     set(x1, y1, EMPTY);
 
-    // Promocja na damk
+    // Promocja na damkę
     Piece moved = get(x2, y2);
     if (moved == WHITE && x2 == 0) {
         moved = WHITE_KING;
@@ -156,36 +186,8 @@ bool Board::movePiece(int x1, int y1, int x2, int y2, bool whiteTurn) {
         int my = (y1 + y2) / 2;
         set(mx, my, EMPTY);
 
-        bool canContinue = false;
-        int dxs[] = { -2, -2, 2, 2 };
-        int dys[] = { -2, 2, -2, 2 };
-        Piece current = get(x2, y2);
-        bool isKing = (current == WHITE_KING || current == BLACK_KING);
-
-        for (int i = 0; i < 4; ++i) {
-            int nx = x2 + dxs[i];
-            int ny = y2 + dys[i];
-            int mx = x2 + dxs[i] / 2;
-            int my = y2 + dys[i] / 2;
-
-            if (!isInside(nx, ny)) continue;
-            if (get(nx, ny) != EMPTY) continue;
-
-            Piece mid = get(mx, my);
-            if (mid == EMPTY || isPlayerPiece(mid, whiteTurn)) continue;
-
-            // pionki mog bi tylko do przodu
-            if (!isKing) {
-                if (whiteTurn && dxs[i] != -2) continue;
-                if (!whiteTurn && dxs[i] != 2) continue;
-            }
-
-            canContinue = true;
-            break;
-        }
-
-
-        if (canContinue) {
+        // pionek, który właśnie doszedł do końca, bije dalej już jako damka
+        if (state.canCaptureFrom(bb::square(x2, y2), whiteTurn)) {
             inCombo = true;
             comboRow = selectedRow = x2;
             comboCol = selectedCol = y2;
@@ -207,545 +209,293 @@ bool Board::movePiece(int x1, int y1, int x2, int y2, bool whiteTurn) {
 }
 
 
-bool Board::hasCapture(bool whiteTurn) const {
-    const int dxs[] = { -2, -2, 2, 2 };
-    const int dys[] = { -2, 2, -2, 2 };
-
-    for (int x = 0; x < SIZE; ++x) {
-        for (int y = 0; y < SIZE; ++y) {
-            Piece p = get(x, y);
-            if (!isPlayerPiece(p, whiteTurn)) continue;
-
-            bool isKing = (p == WHITE_KING || p == BLACK_KING);
-
-            for (int d = 0; d < 4; ++d) {
-                int x2 = x + dxs[d];
-                int y2 = y + dys[d];
-                int mx = x + dxs[d] / 2;
-                int my = y + dys[d] / 2;
-
-                if (!isInside(x2, y2) || !isInside(mx, my)) continue;
-                if (get(x2, y2) != EMPTY) continue;
-
-                Piece mid = get(mx, my);
-                if (mid == EMPTY || isPlayerPiece(mid, whiteTurn)) continue;
-
-                // Pionki mog bi tylko w przd
-                if (!isKing) {
-                    if (whiteTurn && dxs[d] != -2) continue;
-                    if (!whiteTurn && dxs[d] != 2) continue;
-                }
-
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
 
 
 void Board::updatePossibleMoves(int row, int col, bool whiteTurn) const {
     possibleMoves.clear();
+    dirty = true;
 
-    Piece p = get(row, col);
-    if (p == EMPTY) return;
+    if (!isPlayerPiece(get(row, col), whiteTurn)) return;
 
-    bool isCapturePossible = hasCapture(whiteTurn);
-
-    const int dxs[] = { -2, -2, 2, 2, -1, -1, 1, 1 };
-    const int dys[] = { -2, 2, -2, 2, -1, 1, -1, 1 };
-
-    for (int i = 0; i < 8; ++i) {
-        int x2 = row + dxs[i];
-        int y2 = col + dys[i];
-        bool isCapture = false;
-
-        if (isValidMove(row, col, x2, y2, whiteTurn, isCapture)) {
-            // Jeli jakiekolwiek bicie istnieje, dopuszczaj TYLKO ruchy bdce biciem
-            if ((inCombo || isCapturePossible) && isCapture)
-                possibleMoves.push_back({ x2, y2 });
-            else if (!isCapturePossible && !inCombo)
-                possibleMoves.push_back({ x2, y2 });
-
-
-
-        }
+    // Jeśli jakiekolwiek bicie istnieje, targetsFrom daje TYLKO ruchy będące biciem
+    Bitboard targets = state.targetsFrom(bb::square(row, col), whiteTurn, inCombo);
+    while (targets) {
+        int sq = bb::popLsb(targets);
+        possibleMoves.push_back({ bb::row(sq), bb::col(sq) });
     }
 }
 
 void Board::loadScenario(int id) {
-    std::fill(board.begin(), board.end(), EMPTY);
-
-    // Domylnie usu zaznaczenie
+    // Domyślnie usuń zaznaczenie
     selectedRow = selectedCol = -1;
     possibleMoves.clear();
+    dirty = true;
 
-    switch (id) {
-    case 1: // Bicie obowizkowe  inny pionek nie moe si ruszy
-        set(5, 2, WHITE);
-        set(6, 6, WHITE);
-        set(4, 3, BLACK);
-        break;
-
-    case 2: // Bicie wielokrotne
-        set(5, 2, WHITE);
-        set(4, 3, BLACK);
-        set(4, 5, BLACK);
-        set(2, 3, BLACK);
-        break;
-
-    case 3: // Prba ruchu pionka w ty (niedozwolona)
-        set(4, 4, WHITE);
-        break;
-
-    case 4: // Bicie do tyu dozwolone
-        set(4, 4, WHITE);
-        set(3, 3, BLACK);
-        break;
-
-    case 5: // Promocja na damk
-        set(1, 2, WHITE);
-        break;
-
-    case 6: // Ruch damki w dowolnym kierunku
-        set(4, 4, WHITE_KING);
-        break;
-
-    case 7: // Bicie damk w ty i przd
-        set(4, 4, WHITE_KING);
-        set(3, 3, BLACK);
-        set(5, 5, BLACK);
-        break;
-
-    case 8: // Tylko jeden pionek moe bi  inne nie mog si ruszy
-        set(5, 0, WHITE);
-        set(5, 6, WHITE);
-        set(4, 1, BLACK);
-        break;
-    case 9: // Tylko jeden pionek moe kontynuowa bicie
-        set(4, 1, WHITE);
-        set(5, 6, WHITE);
-        set(3, 2, BLACK);
-        set(1, 4, BLACK);
-        set(4, 5, BLACK);
-        break;
-    case 10: // Bd: wybrany pionek moe ruszy si bez bicia
-        set(5, 2, WHITE);   // Bije w prawo
-        set(4, 3, BLACK);
-        set(5, 6, WHITE);   // Ten pionek nie moe si ruszy
-        break;
-
-    case 11: // AI moe wygra ruchem bicia
-        set(2, 3, BLACK); // AI (Black) pionek
-        set(3, 4, WHITE); // Gracz (White) pionek
-        break;
-
-
-
-    default:
-        break;
-    }
+    scenario::load(state, id);
 }
 
 void Board::play(sf::RenderWindow& window, const GameSettings& settings) {
     constexpr int TILE_SIZE = 80;
     bool whiteTurn = true;
-    bool wasMouseDown = false;
     sf::Clock aiClock;
-    const sf::Time aiDelay = sf::milliseconds(500);  // opnienie AI
-
-    while (window.isOpen()) {
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Escape))
-            window.close();
-
-        // Czy ruch wykonuje AI
-        bool currentAI = (whiteTurn && settings.whitePlayer == PlayerType::AI) ||
-            (!whiteTurn && settings.blackPlayer == PlayerType::AI);
-
-        if (generateAllMoves(whiteTurn).empty()) {
-            std::cout << (whiteTurn ? "White" : "Black") << " has no moves. Game over.\n";
-            break; // zakocz gr
+    const sf::Time aiDelay = sf::milliseconds(500);  // opóźnienie AI
+    const sf::Time POLL_INTERVAL = sf::milliseconds(10); // jak często pętla sprawdza liczenie AI i zegar
+
+    // Bazy końcówek z tbgen, jeśli leżą obok gry (mmap, więc wczytanie nic nie kosztuje).
+    // Zadeklarowane przed ai, żeby żyły dłużej niż wątek przeszukiwania.
+    Tablebase tablebase;
+    if (int tables = tablebase.load("tablebases"))
+        std::cout << "Loaded " << tables << " endgame tables (up to " << tablebase.maxPieces() << " pieces)\n";
+
+    // Księga otwarć z bookgen; ruch z niej zastępuje przeszukiwanie, dopóki pozycja jest w księdze
+    Book book;
+    if (settings.bookMode != BookMode::Off && book.open("book.bin"))
+        std::cout << "Loaded opening book (" << book.size() << " entries)\n";
+    std::mt19937 bookRng(std::random_device{}());
+
+    SearchService ai; // liczy w osobnym wątku na kopii stanu
+    ai.resizeTT(settings.ttSizeMB);
+    ai.setThreads(settings.searchThreads);
+    ai.setTablebase(&tablebase);
+    sf::Clock searchClock;
+
+    // Statystyki: pozycja, którą liczy ai (do zapisu PV), wynik ostatniego ruchu AI i log JSON
+    showStats = settings.statsOverlay;
+    hasStatsFont = statsFont.openFromFile("arial.ttf");
+    GameState searchRoot = state;
+    bool searchRootWhite = true;
+    SearchResult lastSearch;
+    std::string lastPv;
+    std::ofstream statsLog;
+    if (!settings.statsLog.empty())
+        statsLog.open(settings.statsLog, std::ios::app);
+
+    // Zegar partii (settings.clockMs > 0): pozostały czas w ms, [1] = białe, [0] = czarne
+    int clockLeft[2] = { settings.clockMs, settings.clockMs };
+    sf::Clock turnClock;
+    int aiThinkMs = 0; // czas myślenia AI w bieżącej turze (liczony zamiast aiDelay)
+
+    // Ponder: AI liczy pozycję człowieka w czasie jego tury. Po ruchu człowieka TT ma już
+    // odpowiedzi na każdy jego ruch, więc przy stałej głębokości AI kończy kilka razy szybciej,
+    // a przy limicie czasu dostaje połowę budżetu (głębokość wychodzi prawie ta sama).
+    bool ponderStarted = false; // ponder tylko raz na turę człowieka
+    int ponderMs = 0;           // ile liczył ponder przed bieżącym ruchem AI
+    sf::Clock ponderClock;
+
+    auto finishTurn = [&](int usedMs) {
+        if (ai.isPondering()) {
+            SearchResult pondered = ai.stopPonder();
+            ponderMs = ponderClock.getElapsedTime().asMilliseconds();
+            std::cout << "Pondered to depth " << pondered.depth << ", " << pondered.nodes << " nodes in " << ponderMs << " ms\n";
         }
-
-        // Gboko MinMax dla obecnego gracza
-        int depth = whiteTurn ? settings.whiteDepth : settings.blackDepth;
-
-        // Ruch AI
-        if (currentAI && aiClock.getElapsedTime() > aiDelay) {
-            if (!inCombo) {
-                auto [x1, y1, x2, y2] = findBestMove(whiteTurn, whiteTurn ? settings.whiteDepth : settings.blackDepth);
-                if (x1 != -1 && movePiece(x1, y1, x2, y2, whiteTurn)) {
-                    if (!inCombo) whiteTurn = !whiteTurn;
-                    aiClock.restart();
-                }
-            }
-            else {
-                // Kontynuacja kombinacji
-                auto moves = generateAllMoves(whiteTurn);
-                for (auto [x1, y1, x2, y2] : moves) {
-                    if (x1 == comboRow && y1 == comboCol) {
-                        if (movePiece(x1, y1, x2, y2, whiteTurn)) {
-                            if (!inCombo) whiteTurn = !whiteTurn;
-                            aiClock.restart();
-                            break;
-                        }
-                    }
-                }
-            }
+        else {
+            ponderMs = 0;
         }
+        ponderStarted = false;
 
-      
-
-
-        // Obsuga myszy  tylko jeli gracz to czowiek
-        if (!currentAI && sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) {
-            if (!wasMouseDown) {
-                wasMouseDown = true;
-                sf::Vector2i pos = sf::Mouse::getPosition(window);
-                int row = pos.y / TILE_SIZE;
-                int col = pos.x / TILE_SIZE;
-
-                if (selectedRow == -1) {
-                    Piece p = get(row, col);
-                    if (isPlayerPiece(p, whiteTurn)) {
-                        bool isCaptureAvailable = hasCapture(whiteTurn);
-                        bool canCapture = false;
-
-                        if (inCombo) {
-                            if (row == comboRow && col == comboCol) {
-                                selectedRow = row;
-                                selectedCol = col;
-                                updatePossibleMoves(row, col, whiteTurn);
-                            }
-                        }
-                        else {
-                            for (int dx : {-2, 2}) {
-                                for (int dy : {-2, 2}) {
-                                    int x2 = row + dx;
-                                    int y2 = col + dy;
-                                    bool isCap = false;
-                                    if (isValidMove(row, col, x2, y2, whiteTurn, isCap) && isCap)
-                                        canCapture = true;
-                                }
-                            }
-
-                            if (!isCaptureAvailable || canCapture) {
-                                selectedRow = row;
-                                selectedCol = col;
-                                updatePossibleMoves(row, col, whiteTurn);
-                            }
-                        }
+        if (settings.clockMs > 0) {
+            clockLeft[whiteTurn] -= usedMs;
+            if (clockLeft[whiteTurn] > 0)
+                clockLeft[whiteTurn] += settings.incrementMs;
+        }
+        whiteTurn = !whiteTurn;
+        turnClock.restart();
+        aiThinkMs = 0;
+        dirty = true;
+    };
+
+    // Kliknięcie człowieka: najpierw pionek, potem pole docelowe (bicie wielokrotne skok po skoku)
+    auto onClick = [&](int row, int col) {
+        if (selectedRow == -1) {
+            Piece p = get(row, col);
+            if (isPlayerPiece(p, whiteTurn)) {
+                bool isCaptureAvailable = state.hasCapture(whiteTurn);
+                bool canCapture = false;
+
+                if (inCombo) {
+                    if (row == comboRow && col == comboCol) {
+                        selectedRow = row;
+                        selectedCol = col;
+                        updatePossibleMoves(row, col, whiteTurn);
                     }
                 }
                 else {
-                    if (movePiece(selectedRow, selectedCol, row, col, whiteTurn)) {
-                        if (inCombo) {
-                            updatePossibleMoves(comboRow, comboCol, whiteTurn);
-                        }
-                        else {
-                            whiteTurn = !whiteTurn;
-                            possibleMoves.clear();
-                        }
-                    }
+                    canCapture = state.canCaptureFrom(bb::square(row, col), whiteTurn);
 
-                    if (!inCombo) {
-                        selectedRow = selectedCol = -1;
-                        possibleMoves.clear();
+                    if (!isCaptureAvailable || canCapture) {
+                        selectedRow = row;
+                        selectedCol = col;
+                        updatePossibleMoves(row, col, whiteTurn);
                     }
                 }
             }
         }
         else {
-            wasMouseDown = false;
-        }
-
-        // Rysowanie
-        window.clear();
-        draw(window);
-        window.display();
-    }
-}
-
-bool Board::canBeCaptured(int row, int col, bool isWhite) const {
-    const int dirs[4][2] = { {-2,-2}, {-2,2}, {2,-2}, {2,2} };
-
-    for (auto [dx, dy] : dirs) {
-        int x2 = row + dx;
-        int y2 = col + dy;
-        int mx = row + dx / 2;
-        int my = col + dy / 2;
-
-        if (!isInside(x2, y2) || !isInside(mx, my)) continue;
-
-        Piece middle = get(mx, my);
-        Piece destination = get(x2, y2);
+            if (movePiece(selectedRow, selectedCol, row, col, whiteTurn)) {
+                if (inCombo) {
+                    updatePossibleMoves(comboRow, comboCol, whiteTurn);
+                }
+                else {
+                    finishTurn(turnClock.getElapsedTime().asMilliseconds());
+                    possibleMoves.clear();
+                }
+            }
 
-        if ((isWhite && isPlayerPiece(middle, false)) || (!isWhite && isPlayerPiece(middle, true))) {
-            if (destination == EMPTY)
-                return true;
+            if (!inCombo) {
+                selectedRow = selectedCol = -1;
+                possibleMoves.clear();
+            }
         }
-    }
-    return false;
-}
-
-int Board::evaluate() const {
-    const int PAWN_VALUE = 100;
-    const int KING_VALUE = 200;
-    const int THREAT_PENALTY = 200;
+        dirty = true;
+    };
 
-    int score = 0;
+    auto isAI = [&](bool white) { return (white ? settings.whitePlayer : settings.blackPlayer) == PlayerType::AI; };
 
-    for (int i = 0; i < SIZE; ++i) {
-        for (int j = 0; j < SIZE; ++j) {
-            Piece p = get(i, j);
-            if (p == EMPTY) continue;
-
-            bool isWhite = (p == WHITE || p == WHITE_KING);
-            int value = 0;
-
-            if (p == WHITE || p == BLACK)
-                value += PAWN_VALUE;
-            else
-                value += KING_VALUE;
+    while (window.isOpen()) {
+        const bool turnAtStart = whiteTurn;
 
-            if (canBeCaptured(i, j, isWhite))
-                value -= THREAT_PENALTY;
+        // Czy ruch wykonuje AI
+        bool currentAI = isAI(whiteTurn);
 
-            score += isWhite ? value : -value;
+        if (state.isGameOver(whiteTurn)) {
+            std::cout << (whiteTurn ? "White" : "Black") << " has no moves. Game over.\n";
+            break; // zakończ grę
         }
-    }
-
-    return score;
-}
-
-
-std::vector<std::tuple<int, int, int, int>> Board::generateAllMoves(bool whiteTurn) const {
-    if (inCombo) {
-        std::vector<std::tuple<int, int, int, int>> comboMoves;
 
-        for (int dx = -2; dx <= 2; ++dx) {
-            for (int dy = -2; dy <= 2; ++dy) {
-                if (dx == 0 || dy == 0) continue;
-
-                int x2 = comboRow + dx;
-                int y2 = comboCol + dy;
-                bool isCap = false;
-                if (isValidMove(comboRow, comboCol, x2, y2, whiteTurn, isCap) && isCap) {
-                    comboMoves.emplace_back(comboRow, comboCol, x2, y2);
-                }
+        if (settings.clockMs > 0) {
+            int used = turnClock.getElapsedTime().asMilliseconds();
+            if (currentAI)
+                used = aiThinkMs + (ai.isSearching() ? searchClock.getElapsedTime().asMilliseconds() : 0);
+            if (clockLeft[whiteTurn] - used <= 0) {
+                std::cout << (whiteTurn ? "White" : "Black") << " lost on time. Game over.\n";
+                break;
             }
         }
 
-        return comboMoves;
-    }
-
-    std::vector<std::tuple<int, int, int, int>> moves;
-    bool mustCapture = hasCapture(whiteTurn);  // SPRAWDZENIE OBOWIZKOWEGO BICIA
-
-    for (int x = 0; x < SIZE; ++x) {
-        for (int y = 0; y < SIZE; ++y) {
-            Piece p = get(x, y);
-            if (!isPlayerPiece(p, whiteTurn)) continue;
-
-            for (int dx = -2; dx <= 2; ++dx) {
-                for (int dy = -2; dy <= 2; ++dy) {
-                    if (dx == 0 || dy == 0) continue;
-                    int x2 = x + dx;
-                    int y2 = y + dy;
-                    bool isCap = false;
-                    if (isValidMove(x, y, x2, y2, whiteTurn, isCap)) {
-                        if (!mustCapture || isCap) {
-                            moves.emplace_back(x, y, x2, y2);
-                        }
-                    }
-                }
-            }
+        if (settings.ponder && !currentAI && isAI(!whiteTurn) && !ponderStarted) {
+            ai.ponder(state, whiteTurn);
+            searchRoot = state;
+            searchRootWhite = whiteTurn;
+            ponderClock.restart();
+            ponderStarted = true;
         }
-    }
-
-    return moves;
-}
-
 
+        // Ruch AI - liczony w tle, okno w tym czasie dalej się odświeża
+        if (currentAI && !ai.isSearching() && aiClock.getElapsedTime() > aiDelay) {
+            auto bookStart = std::chrono::steady_clock::now();
+            Move bookMove = book.pick(state, whiteTurn, settings.bookMode == BookMode::Random, bookRng);
+            if (!bookMove.isNull()) {
+                std::cout << (whiteTurn ? "White" : "Black") << " AI: book move " << notation::moveToString(state, whiteTurn, bookMove)
+                    << " in " << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bookStart).count()
+                    << " us\n";
+                state.applyMove(bookMove, whiteTurn);
+                finishTurn(0);
+                aiClock.restart();
+                continue;
+            }
 
+            // Limit czasu na ruch; przy zegarze partii nie więcej niż ~1/20 pozostałego czasu
+            int timeMs = whiteTurn ? settings.whiteMoveTimeMs : settings.blackMoveTimeMs;
+            if (settings.clockMs > 0) {
+                int left = clockLeft[whiteTurn];
+                int budget = std::max(1, std::min(left / 20 + settings.incrementMs * 3 / 4, left - 50));
+                timeMs = timeMs > 0 ? std::min(timeMs, budget) : budget;
+            }
+            if (timeMs > 1 && ponderMs > 0)
+                timeMs -= std::min(ponderMs, timeMs / 2);
 
-int Board::minimax(int depth, int alpha, int beta, bool maximizingPlayer, bool whiteTurn) {
-    if (isGameOver(whiteTurn))
-        return whiteTurn ? INT_MIN + 1 : INT_MAX - 1;
-
-    if (depth == 0)
-        return evaluate();
-
-    auto moves = generateAllMoves(whiteTurn);
-    if (moves.empty())
-        return maximizingPlayer ? -10000 : 10000;
-
-    int bestEval = maximizingPlayer ? INT_MIN : INT_MAX;
-
-    for (auto [x1, y1, x2, y2] : moves) {
-        MoveBackup backup = applyMove(x1, y1, x2, y2, whiteTurn);
-
-        // Czy po tym ruchu AI ma kontynuowa combo?
-        bool continueCombo = inCombo && comboRow == x2 && comboCol == y2;
+            // Z limitem czasu głębokość nie jest ograniczona
+            int depth = timeMs > 0 ? MAX_SEARCH_DEPTH : (whiteTurn ? settings.whiteDepth : settings.blackDepth);
 
-        int eval;
-        if (continueCombo) {
-            // Ten sam gracz gra dalej  gboko nie spada
-            eval = minimax(depth, alpha, beta, maximizingPlayer, whiteTurn);
+            ai.start(state, whiteTurn, depth, timeMs);
+            searchRoot = state;
+            searchRootWhite = whiteTurn;
+            searchClock.restart();
         }
-        else {
-            // Nastpny gracz  przecz kolor i zmniejsz gboko
-            eval = minimax(depth - 1, alpha, beta, !maximizingPlayer, !whiteTurn);
+        else if (currentAI && ai.isReady()) {
+            SearchResult result = ai.take();
+            aiThinkMs += searchClock.getElapsedTime().asMilliseconds();
+
+            std::cout << (whiteTurn ? "White" : "Black") << " AI: depth " << result.depth
+                << ", score " << result.score << ", " << result.nodes << " nodes (" << result.qNodes << " quiescence) in "
+                << aiThinkMs << " ms, TT hits "
+                << result.ttHits << "/" << result.ttProbes << " ("
+                << int(result.ttProbes ? 100 * result.ttHits / result.ttProbes : 0) << "%), branching "
+                << result.branchingFactor() << ", first-move cutoffs " << int(100 * result.firstMoveCutoffRate()) << "%\n";
+            if (statsLog)
+                statsLog << stats::toJson(result, searchRoot, searchRootWhite, ai.threads()) << std::endl;
+            lastSearch = result;
+            lastPv = pvText(searchRoot, searchRootWhite, result.pv);
+
+            // Cała tura naraz, także bicie wielokrotne
+            if (!result.move.isNull()) {
+                state.applyMove(result.move, whiteTurn);
+                finishTurn(aiThinkMs);
+                aiClock.restart();
+            }
         }
 
-        undoMove(backup);
 
-        if (maximizingPlayer) {
-            bestEval = std::max(bestEval, eval);
-            alpha = std::max(alpha, eval);
-        }
-        else {
-            bestEval = std::min(bestEval, eval);
-            beta = std::min(beta, eval);
+        // Nakładka: postęp trwającego liczenia (wątek główny, po każdej iteracji) albo pełne liczniki ostatniego ruchu AI
+        if (showStats) {
+            std::ostringstream text;
+            if (ai.isSearching() || ai.isPondering()) {
+                SearchInfo info = ai.progress();
+                text << (ai.isPondering() ? "Pondering" : "AI thinking") << "\n"
+                    << "depth " << info.depth << ", score " << info.score << "\n"
+                    << "nodes " << info.nodes << ", " << perSecond(info.nodes, info.timeMs) << " nps\n"
+                    << "TT hits " << percent(info.ttHits, info.ttProbes) << "%\n"
+                    << "pv " << pvText(searchRoot, searchRootWhite, info.pv);
+            }
+            else if (lastSearch.depth > 0) {
+                text << "Last AI search: depth " << lastSearch.depth << ", score " << lastSearch.score << "\n"
+                    << "nodes " << lastSearch.nodes << " (" << lastSearch.qNodes << " quiescence), "
+                    << perSecond(lastSearch.nodes, lastSearch.timeMs) << " nps\n"
+                    << "move generations " << lastSearch.moveGenerations << ", evaluations " << lastSearch.evaluations << "\n"
+                    << "TT hits " << percent(lastSearch.ttHits, lastSearch.ttProbes) << "%, branching "
+                    << lastSearch.branchingFactor() << "\n"
+                    << "pv " << lastPv;
+            }
+            if (text.str() != statsText) {
+                statsText = text.str();
+                dirty = true;
+            }
         }
 
-        if (beta <= alpha)
-            break;
-    }
-
-    return bestEval;
-}
-
-
-
-
-std::tuple<int, int, int, int> Board::findBestMove(bool whiteTurn, int depth) {
-    auto moves = generateAllMoves(whiteTurn);
-    if (moves.empty()) {
-        return { -1, -1, -1, -1 }; // brak ruchw = koniec gry
-    }
-
-
-    int bestScore = whiteTurn ? INT_MIN : INT_MAX;
-    std::tuple<int, int, int, int> bestMove = { -1, -1, -1, -1 };
-
-    
-    for (const auto& [x1, y1, x2, y2] : moves) {
-        MoveBackup backup = applyMove(x1, y1, x2, y2, whiteTurn);
-        int score = minimax(depth - 1, INT_MIN, INT_MAX, !whiteTurn, !whiteTurn);;
-        undoMove(backup);
-        
-
-        if ((whiteTurn && score > bestScore) || (!whiteTurn && score < bestScore)) {
-            bestScore = score;
-            bestMove = { x1, y1, x2, y2 };
+        // Rysowanie - tylko gdy coś się zmieniło od ostatniej klatki
+        if (dirty) {
+            window.clear();
+            draw(window);
+            window.display();
         }
-    }
-
-    return bestMove;
-}
-
-bool Board::isGameOver(bool whiteTurn) const {
-    return generateAllMoves(whiteTurn).empty();
-}
-
-Board::MoveBackup Board::applyMove(int x1, int y1, int x2, int y2, bool whiteTurn) {
-    MoveBackup backup;
-    backup.x1 = x1;
-    backup.y1 = y1;
-    backup.x2 = x2;
-    backup.y2 = y2;
-    backup.movedPiece = get(x1, y1);
-    backup.wasKingBefore = (backup.movedPiece == WHITE_KING || backup.movedPiece == BLACK_KING);
-
-    // Zapamitaj stan combo
-    backup.inComboBefore = inCombo;
-    backup.comboRowBefore = comboRow;
-    backup.comboColBefore = comboCol;
-    backup.selectedRowBefore = selectedRow;
-    backup.selectedColBefore = selectedCol;
-
-    // Wykonaj ruch
-    set(x2, y2, backup.movedPiece);
-    set(x1, y1, EMPTY);
 
-    // Bicie
-    if (std::abs(x2 - x1) == 2) {
-        int mx = (x1 + x2) / 2;
-        int my = (y1 + y2) / 2;
-        backup.capturedX = mx;
-        backup.capturedY = my;
-        backup.capturedPiece = get(mx, my);
-        set(mx, my, EMPTY);
-    }
-    else {
-        backup.capturedPiece = EMPTY;
-    }
-
-    // Promocja
-    if (backup.movedPiece == WHITE && x2 == 0) set(x2, y2, WHITE_KING);
-    if (backup.movedPiece == BLACK && x2 == SIZE - 1) set(x2, y2, BLACK_KING);
-
-    // Sprawdzenie kontynuacji combosa
-    bool canContinue = false;
-    Piece current = get(x2, y2);
-    bool isKing = (current == WHITE_KING || current == BLACK_KING);
-    const int dxs[] = { -2, -2, 2, 2 };
-    const int dys[] = { -2, 2, -2, 2 };
-
-    for (int i = 0; i < 4; ++i) {
-        int nx = x2 + dxs[i];
-        int ny = y2 + dys[i];
-        int mx = x2 + dxs[i] / 2;
-        int my = y2 + dys[i] / 2;
-
-        if (!isInside(nx, ny) || !isInside(mx, my)) continue;
-        if (get(nx, ny) != EMPTY) continue;
-        Piece mid = get(mx, my);
-        if (mid == EMPTY || isPlayerPiece(mid, whiteTurn)) continue;
-
-        if (!isKing) {
-            if (whiteTurn && dxs[i] != -2) continue;
-            if (!whiteTurn && dxs[i] != 2) continue;
+        // Bez pracy w tle pętla śpi w waitEvent do następnego zdarzenia, więc bezczynne okno nie zajmuje rdzenia.
+        // Ruch AI (także opóźnienie aiDelay), ponder, zegar partii i świeżo zmieniona tura są sprawdzane co POLL_INTERVAL.
+        bool busy = whiteTurn != turnAtStart || isAI(whiteTurn) || ai.isPondering() || settings.clockMs > 0;
+        for (std::optional event = window.waitEvent(busy ? POLL_INTERVAL : sf::Time::Zero); event; event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>()) {
+                window.close();
+            }
+            else if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
+                if (key->code == sf::Keyboard::Key::Escape)
+                    window.close();
+                else if (key->code == sf::Keyboard::Key::S) {
+                    showStats = !showStats;
+                    dirty = true;
+                }
+            }
+            else if (const auto* click = event->getIf<sf::Event::MouseButtonPressed>()) {
+                // Obsługa myszy — tylko jeśli gracz to człowiek
+                if (click->button == sf::Mouse::Button::Left && !isAI(whiteTurn))
+                    onClick(click->position.y / TILE_SIZE, click->position.x / TILE_SIZE);
+            }
+            else if (event->is<sf::Event::FocusGained>() || event->is<sf::Event::Resized>()) {
+                dirty = true; // zawartość okna mogła przepaść
+            }
         }
-
-        canContinue = true;
-        break;
-    }
-
-    if (canContinue) {
-        inCombo = true;
-        comboRow = x2;
-        comboCol = y2;
-        selectedRow = x2;
-        selectedCol = y2;
+        if (!window.isOpen())
+            ai.cancel(); // nie czekaj na koniec liczenia
     }
-    else {
-        inCombo = false;
-        comboRow = comboCol = -1;
-        selectedRow = selectedCol = -1;
-    }
-
-    return backup;
-}
-
-
-void Board::undoMove(const MoveBackup& backup) {
-    set(backup.x1, backup.y1, backup.movedPiece);
-    set(backup.x2, backup.y2, EMPTY);
-
-    if (backup.capturedPiece != EMPTY) {
-        set(backup.capturedX, backup.capturedY, backup.capturedPiece);
-    }
-
-    // Przywr stan combo
-    inCombo = backup.inComboBefore;
-    comboRow = backup.comboRowBefore;
-    comboCol = backup.comboColBefore;
-    selectedRow = backup.selectedRowBefore;
-    selectedCol = backup.selectedColBefore;
 }
 
 
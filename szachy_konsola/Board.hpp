@@ -1,10 +1,12 @@
-#pragma once
+﻿#pragma once
 #include <vector>
 #include <string>
 #include <SFML/Graphics.hpp>
 #include <tuple>
-#include <limits> // dla INT_MIN / INT_MAX
+#include <climits> // dla INT_MIN / INT_MAX
 #include "GameSettings.hpp" 
+#include "GameState.hpp"
+#include "Geometry.hpp"
 
 
 constexpr int TILE_SIZE = 80;
@@ -15,58 +17,50 @@ class Board {
 public:
     
 
-    static const int SIZE = 8;
+    static constexpr int SIZE = rules::Board8::SIZE; // wymiary i numeracja pól jak w GameState
     Board();
     void draw(sf::RenderWindow& window) const;
     void play(sf::RenderWindow& window, const GameSettings& settings);
-    void loadScenario(int id); //do testw tylko
+    void loadScenario(int id); //do testów tylko
     
 
 
 private:
     mutable int selectedRow = -1, selectedCol = -1;
     mutable std::vector<std::pair<int, int>> possibleMoves;
+
+    // Bicie wielokrotne człowieka idzie skok po skoku - AI dostaje całą drogę jako jeden Move
     mutable bool inCombo = false;
     mutable int comboRow = -1, comboCol = -1;
+
+    // Rysowanie: pola planszy w siatce budowanej raz w konstruktorze, figury i podświetlenia w drugiej,
+    // przebudowywanej tylko po zmianie (dirty). play() też rysuje klatkę tylko wtedy.
+    sf::VertexArray tiles;
+    mutable sf::VertexArray pieces;
+    mutable bool dirty = true;
+    void rebuildPieces() const;
+
+    // Nakładka ze statystykami przeszukiwania (klawisz S) - tekst składa play(), draw() go tylko rysuje
+    bool showStats = false;
+    std::string statsText;
+    sf::Font statsFont;
+    bool hasStatsFont = false;
     
 
 
 
     enum Piece { EMPTY, WHITE, WHITE_KING, BLACK, BLACK_KING };
-    std::vector<Piece> board;
-    
-    struct MoveBackup {
-        int x1, y1, x2, y2;
-        Piece movedPiece;
-        Piece capturedPiece;
-        int capturedX = -1, capturedY = -1;
-        bool wasKingBefore = false;
-
-        //wartoci do combo
-        bool inComboBefore;
-        int comboRowBefore, comboColBefore;
-        int selectedRowBefore, selectedColBefore;
-    };
+    GameState state; // reguły i AI działają na tym stanie, get/set to tylko widok na bitboardy
 
 
 
     bool isValidMove(int x1, int y1, int x2, int y2, bool whiteTurn, bool& isCapture) const;
     bool movePiece(int x1, int y1, int x2, int y2, bool whiteTurn);
     std::string pieceToStr(Piece p) const;
-    bool isInside(int x, int y) const;
     bool isPlayerPiece(Piece p, bool whiteTurn) const;
     Piece get(int x, int y) const;
     void set(int x, int y, Piece value);
-    bool hasCapture(bool whiteTurn) const;
     void updatePossibleMoves(int x, int y, bool whiteTurn) const;
-    int evaluate() const;
-    std::vector<std::tuple<int, int, int, int>> generateAllMoves(bool whiteTurn) const;
-    int minimax(int depth, int alpha, int beta, bool maximizingPlayer, bool whiteTurn);
-    std::tuple<int, int, int, int> findBestMove(bool whiteTurn, int depth);
-    bool canBeCaptured(int row, int col, bool isWhite) const;
-    bool isGameOver(bool whiteTurn) const;
-    MoveBackup applyMove(int x1, int y1, int x2, int y2, bool whiteTurn);
-    void undoMove(const MoveBackup& backup);
 
 
 };
\ No newline at end of file
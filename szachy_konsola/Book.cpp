@@ -0,0 +1,101 @@
+#include "Book.hpp"
+#include <cstring>
+
+namespace {
+    uint64_t readLe(const uint8_t* p, int bytes) {
+        uint64_t v = 0;
+        for (int i = bytes - 1; i >= 0; --i)
+            v = v << 8 | p[i];
+        return v;
+    }
+
+    void writeLe(uint8_t* p, uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i)
+            p[i] = uint8_t(v >> (8 * i));
+    }
+}
+
+void book::encode(const Entry& e, uint8_t* out) {
+    writeLe(out, e.key, 8);
+    writeLe(out + 8, e.move.captured(), 4);
+    writeLe(out + 12, e.move.packed(), 2);
+    writeLe(out + 14, uint64_t(e.weight), 2);
+}
+
+book::Entry book::decode(const uint8_t* in) {
+    Entry e;
+    e.key = readLe(in, 8);
+    Bitboard captured = Bitboard(readLe(in + 8, 4));
+    int packed = int(readLe(in + 12, 2));
+    e.move = Move(packed & 31, (packed >> 5) & 31, captured, (packed & (1 << 11)) != 0);
+    e.weight = int(readLe(in + 14, 2));
+    return e;
+}
+
+bool Book::open(const std::string& path) {
+    count = 0;
+    if (!file.open(path) || file.size() < book::HEADER_SIZE || std::memcmp(file.data(), "WBK1", 4) != 0) {
+        file.close();
+        return false;
+    }
+
+    uint64_t entries = readLe(file.data() + 8, 8);
+    if (file.size() != book::HEADER_SIZE + entries * book::ENTRY_SIZE) {
+        file.close();
+        return false;
+    }
+    count = size_t(entries);
+    return true;
+}
+
+uint64_t Book::keyAt(size_t i) const {
+    return readLe(file.data() + book::HEADER_SIZE + i * book::ENTRY_SIZE, 8);
+}
+
+std::vector<book::Entry> Book::lookup(const GameState& state, bool whiteTurn) const {
+    std::vector<book::Entry> found;
+    if (!count)
+        return found;
+
+    // Pierwszy wpis z kluczem >= key
+    uint64_t key = state.key(whiteTurn);
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (keyAt(mid) < key) lo = mid + 1;
+        else hi = mid;
+    }
+
+    MoveList legal;
+    state.generateMoves(whiteTurn, legal);
+    for (size_t i = lo; i < count && keyAt(i) == key; ++i) {
+        book::Entry e = book::decode(file.data() + book::HEADER_SIZE + i * book::ENTRY_SIZE);
+        for (Move m : legal)
+            if (m == e.move) {
+                found.push_back(e);
+                break;
+            }
+    }
+    return found;
+}
+
+Move Book::pick(const GameState& state, bool whiteTurn, bool weightedRandom, std::mt19937& rng) const {
+    std::vector<book::Entry> entries = lookup(state, whiteTurn);
+    if (entries.empty())
+        return Move();
+    if (!weightedRandom)
+        return entries.front().move;
+
+    int total = 0;
+    for (const book::Entry& e : entries)
+        total += e.weight;
+    if (total <= 0)
+        return entries.front().move;
+    int r = std::uniform_int_distribution<int>(0, total - 1)(rng);
+    for (const book::Entry& e : entries) {
+        if (r < e.weight)
+            return e.move;
+        r -= e.weight;
+    }
+    return entries.front().move;
+}
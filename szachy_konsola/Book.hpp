@@ -0,0 +1,49 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+#include "GameState.hpp"
+#include "MappedFile.hpp"
+
+// Księga otwarć z tools/BookGen.cpp: wpisy (pozycja, ruch, waga) posortowane po kluczu Zobrista,
+// czytane przez mmap i wyszukiwane binarnie - ruch z księgi nie kosztuje żadnego przeszukiwania.
+//
+// Plik: "WBK1", 4 bajty zarezerwowane, liczba wpisów (u64), potem wpisy po 16 bajtów:
+// klucz (u64), zbite pola (u32), ruch packed() (u16), waga (u16). Wszystko little-endian.
+// Wpisy jednej pozycji leżą obok siebie, od największej wagi.
+namespace book {
+    constexpr size_t HEADER_SIZE = 16;
+    constexpr size_t ENTRY_SIZE = 16;
+
+    struct Entry {
+        uint64_t key = 0;
+        Move move;
+        int weight = 0; // 1..65535, najlepszy ruch pozycji ma największą
+    };
+
+    void encode(const Entry& e, uint8_t* out); // ENTRY_SIZE bajtów
+    Entry decode(const uint8_t* in);
+}
+
+class Book {
+public:
+    bool open(const std::string& path); // false = brak pliku albo zły format
+    bool isOpen() const { return file.isOpen(); }
+    size_t size() const { return count; }
+
+    // Legalne ruchy z księgi dla pozycji, od największej wagi (klucz może się powtórzyć
+    // przy kolizji Zobrista, więc każdy ruch jest sprawdzany z generatorem)
+    std::vector<book::Entry> lookup(const GameState& state, bool whiteTurn) const;
+
+    // Ruch o największej wadze albo losowy z prawdopodobieństwem proporcjonalnym do wagi;
+    // Move() = pozycji nie ma w księdze
+    Move pick(const GameState& state, bool whiteTurn, bool weightedRandom, std::mt19937& rng) const;
+
+private:
+    MappedFile file;
+    size_t count = 0;
+
+    uint64_t keyAt(size_t i) const;
+};
@@ -0,0 +1,56 @@
+﻿#pragma once
+#include <cstdint>
+#include "Bitboard.hpp"
+
+// Cechy oceny pozycji. Ocena to suma waga * cecha, a wagi są w EvalWeights.hpp,
+// generowanym przez tools/Tune.cpp (strojenie metodą Texela na partiach z turnieju).
+// Każda cecha to liczba figur białych minus czarnych, więc kary mają wagi ujemne.
+// MAN to skala oceny (100 = pion) - strojenie go nie zmienia, a granice pozostałych wag są w tools/Tune.cpp.
+namespace eval {
+    enum Feature : int {
+        Man,      // piony
+        King,     // damki
+        Threat,   // figury, które przeciwnik może zbić (threatened); w stand-pat to tylko figury strony na ruchu
+        Advanced, // piony na trzech wierszach przed promocją
+        BackRank, // piony na własnym ostatnim wierszu (zamykają przeciwnikowi pola promocji)
+        Center,   // figury na czterech środkowych polach
+        FEATURES
+    };
+
+    constexpr const char* FEATURE_NAMES[FEATURES] = { "MAN", "KING", "THREAT", "ADVANCED", "BACK_RANK", "CENTER" };
+
+    constexpr Bitboard WHITE_ADVANCED = 0x0000FFF0u; // wiersze 1-3
+    constexpr Bitboard BLACK_ADVANCED = 0x0FFF0000u; // wiersze 4-6
+    constexpr Bitboard CENTER = 0x00066000u;         // pola 13, 14, 17, 18
+
+    // Figury obu stron, które przeciwnik może zbić: figura W jest bita w kierunku d, gdy na W - d stoi wróg,
+    // który może iść w kierunku d (pion tylko do przodu, damka w każdą stronę), a pole W + d jest puste
+    constexpr Bitboard threatened(Bitboard white, Bitboard black, Bitboard kings) {
+        Bitboard empty = ~(white | black);
+        Bitboard threats = 0;
+        for (int d = 0; d < 4; ++d) {
+            Bitboard landing = bb::shift(empty, bb::opposite(d)); // pola, za którymi w kierunku d jest puste
+            Bitboard whiteAttackers = bb::isForward(d, true) ? white : white & kings;
+            Bitboard blackAttackers = bb::isForward(d, false) ? black : black & kings;
+            threats |= bb::shift(whiteAttackers, d) & black & landing;
+            threats |= bb::shift(blackAttackers, d) & white & landing;
+        }
+        return threats;
+    }
+
+    inline int diff(Bitboard white, Bitboard black) { return bb::popCount(white) - bb::popCount(black); }
+
+    // Wszystkie cechy liczone od zera, bez rozgałęzień - tools/Tune.cpp woła to w pętli po tysiącach pozycji
+    template <typename T>
+    inline void extract(Bitboard white, Bitboard black, Bitboard kings, T out[FEATURES]) {
+        Bitboard whiteMen = white & ~kings, blackMen = black & ~kings;
+        Bitboard threats = threatened(white, black, kings);
+
+        out[Man] = T(diff(whiteMen, blackMen));
+        out[King] = T(diff(white & kings, black & kings));
+        out[Threat] = T(diff(threats & white, threats & black));
+        out[Advanced] = T(diff(whiteMen & WHITE_ADVANCED, blackMen & BLACK_ADVANCED));
+        out[BackRank] = T(diff(whiteMen & bb::ROW_7, blackMen & bb::ROW_0));
+        out[Center] = T(diff(white & CENTER, black & CENTER));
+    }
+}
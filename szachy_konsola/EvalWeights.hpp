@@ -0,0 +1,14 @@
+﻿#pragma once
+#include "Eval.hpp"
+
+// Wygenerowane przez tools/Tune.cpp - nie edytować ręcznie, tylko przestroić: tune fit --out EvalWeights.hpp
+// 1460006 spokojnych pozycji (tune extract) z 18000 partii samogry turnieju na głębokości 4/5
+// 1460006 positions from positions.bin, K 0.5295, error 0.044499 -> 0.044024
+constexpr int EVAL_WEIGHTS[eval::FEATURES] = {
+    100, // MAN
+    125, // KING
+    -30, // THREAT
+    0, // ADVANCED
+    6, // BACK_RANK
+    0, // CENTER
+};
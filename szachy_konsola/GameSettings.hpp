@@ -1,12 +1,36 @@
-#pragma once
+﻿#pragma once
+#include <thread>
+#include <string>
 
 enum class PlayerType { Human, AI };
 
+// Księga otwarć (book.bin z tools/BookGen.cpp): wyłączona, zawsze najlepszy ruch albo losowy według wag
+enum class BookMode { Off, Best, Random };
+
 struct GameSettings {
     PlayerType whitePlayer = PlayerType::Human;
     PlayerType blackPlayer = PlayerType::Human;
     int whiteDepth = 3;
     int blackDepth = 3;
+    int ttSizeMB = 64; // rozmiar tablicy transpozycji w MB (0 = brak)
+
+    // Wątki przeszukiwania AI (Lazy SMP); domyślnie wszystkie rdzenie
+    int searchThreads = std::thread::hardware_concurrency() > 0 ? int(std::thread::hardware_concurrency()) : 1;
+
+    // Limit czasu na ruch w ms (0 = stała głębokość). Z limitem głębokość nie jest ograniczana.
+    int whiteMoveTimeMs = 0;
+    int blackMoveTimeMs = 0;
+
+    // Opcjonalny zegar partii: czas na stronę i dodatek po każdym ruchu (0 = bez zegara)
+    int clockMs = 0;
+    int incrementMs = 0;
+
+    BookMode bookMode = BookMode::Random; // bez pliku księgi AI po prostu liczy
+
+    bool ponder = true; // AI liczy też w czasie ruchu człowieka
+
+    bool statsOverlay = false;                   // statystyki przeszukiwania na planszy (w grze przełącza je S)
+    std::string statsLog = "search_stats.jsonl"; // linia JSON po każdym ruchu AI (pusty = bez logu)
 };
 
 
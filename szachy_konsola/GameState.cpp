@@ -0,0 +1,255 @@
+﻿#include "GameState.hpp"
+#include "Zobrist.hpp"
+#include "Stats.hpp"
+#include "Geometry.hpp"
+#include <cstdlib>
+#include <cassert>
+
+namespace {
+    // Stałe wagi wariantów odniesienia (EvalVariant) - ręczna ocena sprzed strojenia
+    constexpr int REFERENCE_MAN = 100;
+    constexpr int REFERENCE_KING = 200;
+    constexpr int REFERENCE_THREAT = 200; // figura pod biciem w liściu bez quiescence
+    constexpr int REFERENCE_HANGING = 50; // to samo w stand-pat - jedną figurę zwykle da się uratować
+}
+
+void GameState::clear() {
+    pos = Position();
+    hash = 0;
+    material = 0;
+}
+
+void GameState::putPiece(int sq, bool white, bool king) {
+    removePiece(sq);
+
+    Bitboard b = bb::bit(sq);
+    (white ? pos.white : pos.black) |= b;
+    if (king) pos.kings |= b;
+    hash ^= zobrist::pieceKey(sq, white, king);
+    material += (white ? 1 : -1) * (king ? KING_VALUE : PAWN_VALUE);
+}
+
+void GameState::removePiece(int sq) {
+    Bitboard b = bb::bit(sq);
+    if (!(pos.occupied() & b)) return;
+
+    bool white = (pos.white & b) != 0, king = (pos.kings & b) != 0;
+    hash ^= zobrist::pieceKey(sq, white, king);
+    material -= (white ? 1 : -1) * (king ? KING_VALUE : PAWN_VALUE);
+    pos.white &= ~b;
+    pos.black &= ~b;
+    pos.kings &= ~b;
+}
+
+uint64_t GameState::key(bool whiteTurn) const {
+    // Stan nie pamięta, kto jest na ruchu, więc stronę dokładamy do klucza tutaj
+    return whiteTurn ? hash : hash ^ zobrist::KEYS.blackToMove;
+}
+
+bool GameState::hasCapture(bool whiteTurn) const {
+    for (int d = 0; d < 4; ++d) {
+        if (pos.jumpTargets(pos.movers(whiteTurn, d), whiteTurn, d))
+            return true;
+    }
+    return false;
+}
+
+bool GameState::canCaptureFrom(int sq, bool whiteTurn) const {
+    Bitboard b = bb::bit(sq);
+    for (int d = 0; d < 4; ++d) {
+        if (pos.jumpTargets(b & pos.movers(whiteTurn, d), whiteTurn, d))
+            return true;
+    }
+    return false;
+}
+
+bool GameState::canBeCaptured(int row, int col, bool isWhite) const {
+    Bitboard b = bb::bit(bb::square(row, col));
+    Bitboard empty = pos.empty();
+
+    // Bijący stoi przed figurą i skacze nad nią w kierunku d - pion przeciwnika tylko do przodu
+    for (int d = 0; d < 4; ++d) {
+        if ((bb::shift(b, bb::opposite(d)) & pos.movers(!isWhite, d)) && (bb::shift(b, d) & empty))
+            return true;
+    }
+    return false;
+}
+
+Bitboard GameState::targetsFrom(int sq, bool whiteTurn, bool continuing) const {
+    // Tablice z Geometry.hpp: sąsiad i pole za nim, -1 poza planszą (pole za krawędzią też jest -1)
+    constexpr const auto& STEP = rules::STEP<rules::Board8>;
+    constexpr const auto& JUMP = rules::JUMP<rules::Board8>;
+
+    bool king = (pos.kings & bb::bit(sq)) != 0;
+    bool capture = continuing || hasCapture(whiteTurn);
+    Bitboard enemy = pos.pieces(!whiteTurn), empty = pos.empty();
+    Bitboard targets = 0;
+
+    for (int d = 0; d < 4; ++d) {
+        if (!king && !bb::isForward(d, whiteTurn)) continue;
+        int to = capture ? JUMP(sq, d) : STEP(sq, d);
+        if (to < 0 || !(empty & bb::bit(to))) continue;
+        if (!capture || (enemy & bb::bit(STEP(sq, d))))
+            targets |= bb::bit(to);
+    }
+    return targets;
+}
+
+Bitboard GameState::threatened() const {
+    return eval::threatened(pos.white, pos.black, pos.kings);
+}
+
+int GameState::positional() const {
+    Bitboard whiteMen = pos.white & ~pos.kings, blackMen = pos.black & ~pos.kings;
+    return EVAL_WEIGHTS[eval::Advanced] * eval::diff(whiteMen & eval::WHITE_ADVANCED, blackMen & eval::BLACK_ADVANCED)
+        + EVAL_WEIGHTS[eval::BackRank] * eval::diff(whiteMen & bb::ROW_7, blackMen & bb::ROW_0)
+        + EVAL_WEIGHTS[eval::Center] * eval::diff(pos.white & eval::CENTER, pos.black & eval::CENTER);
+}
+
+int GameState::evaluate() const {
+    ++stats::local.evaluations;
+    Bitboard threats = threatened();
+    int score = material + EVAL_WEIGHTS[eval::Threat] * eval::diff(threats & pos.white, threats & pos.black) + positional();
+
+    assert(score == evaluateFull() && "przyrostowy materiał rozjechał się z planszą");
+    return score;
+}
+
+int GameState::evaluate(EvalVariant variant, bool quiet) const {
+    if (variant == EvalVariant::Standard)
+        return evaluate();
+    ++stats::local.evaluations;
+
+    // Warianty odniesienia liczą materiał od zera - licznik material idzie za strojonymi wartościami figur
+    int score = REFERENCE_MAN * eval::diff(pos.white & ~pos.kings, pos.black & ~pos.kings)
+        + REFERENCE_KING * eval::diff(pos.white & pos.kings, pos.black & pos.kings);
+    if (variant == EvalVariant::Handcrafted) {
+        Bitboard threats = threatened();
+        score -= (quiet ? REFERENCE_HANGING : REFERENCE_THREAT) * eval::diff(threats & pos.white, threats & pos.black);
+    }
+    return score;
+}
+
+int GameState::evaluateFull() const {
+    int features[eval::FEATURES];
+    eval::extract(pos.white, pos.black, pos.kings, features);
+
+    int score = 0;
+    for (int f = 0; f < eval::FEATURES; ++f)
+        score += EVAL_WEIGHTS[f] * features[f];
+    return score;
+}
+
+void GameState::addCaptures(MoveList& moves, const Position& p, int start, int sq, bool whiteTurn, bool king, Bitboard captured) const {
+    // Skoki jak w turze gracza: zbita figura znika od razu, pion, który doszedł do końca, bije dalej jako damka
+    Bitboard b = bb::bit(sq);
+    bool extended = false;
+
+    for (int d = 0; d < 4; ++d) {
+        if (!king && !bb::isForward(d, whiteTurn)) continue;
+
+        Bitboard over = bb::shift(b, d) & p.pieces(!whiteTurn);
+        Bitboard land = bb::shift(over, d) & p.empty();
+        if (!land) continue;
+
+        Position next = p;
+        (whiteTurn ? next.white : next.black) ^= b | land;
+        (whiteTurn ? next.black : next.white) &= ~over;
+        next.kings &= ~(over | b);
+        bool nowKing = king || (land & (whiteTurn ? bb::ROW_0 : bb::ROW_7)) != 0;
+        if (nowKing) next.kings |= land;
+
+        addCaptures(moves, next, start, bb::lsb(land), whiteTurn, nowKing, captured | over);
+        extended = true;
+    }
+
+    // Bicie kończy się dopiero, gdy nie ma dalszego skoku
+    if (!extended && captured)
+        moves.add(Move(start, sq, captured, king && !(pos.kings & bb::bit(start))));
+}
+
+void GameState::generateMoves(bool whiteTurn, MoveList& moves) const {
+    ++stats::local.moveGenerations;
+    Bitboard own = pos.pieces(whiteTurn);
+
+    if (hasCapture(whiteTurn)) {
+        Bitboard pieces = own;
+        while (pieces) {
+            int sq = bb::popLsb(pieces);
+            addCaptures(moves, pos, sq, sq, whiteTurn, (pos.kings & bb::bit(sq)) != 0, 0);
+        }
+        return; // bicie jest obowiązkowe
+    }
+
+    for (int d = 0; d < 4; ++d) {
+        int back = bb::opposite(d);
+        Bitboard targets = bb::shift(own & pos.movers(whiteTurn, d), d) & pos.empty();
+        while (targets) {
+            int to = bb::popLsb(targets);
+            int from = bb::lsb(bb::shift(bb::bit(to), back));
+            bool promotes = !(pos.kings & bb::bit(from)) && (bb::bit(to) & (whiteTurn ? bb::ROW_0 : bb::ROW_7));
+            moves.add(Move(from, to, 0, promotes));
+        }
+    }
+}
+
+bool GameState::hasMoves(bool whiteTurn) const {
+    if (hasCapture(whiteTurn))
+        return true;
+
+    Bitboard own = pos.pieces(whiteTurn);
+    for (int d = 0; d < 4; ++d) {
+        if (bb::shift(own & pos.movers(whiteTurn, d), d) & pos.empty())
+            return true;
+    }
+    return false;
+}
+
+GameState::MoveBackup GameState::applyMove(Move move, bool whiteTurn) {
+    MoveBackup backup;
+    backup.before = pos;
+    backup.hashBefore = hash;
+    backup.materialBefore = material;
+
+    int from = move.from();
+    int to = move.to();
+    Bitboard fromBit = bb::bit(from);
+    Bitboard toBit = bb::bit(to);
+    Bitboard& own = whiteTurn ? pos.white : pos.black;
+    Bitboard& opp = whiteTurn ? pos.black : pos.white;
+    bool wasKing = (pos.kings & fromBit) != 0;
+    bool isKing = wasKing || move.promotes() || (toBit & (whiteTurn ? bb::ROW_0 : bb::ROW_7)) != 0;
+
+    // Wykonaj ruch (damka może wrócić bijąc na pole startowe, więc bez XOR from | to)
+    own &= ~fromBit;
+    pos.kings &= ~fromBit;
+    own |= toBit;
+    if (isKing)
+        pos.kings |= toBit;
+
+    // Promocja
+    if (isKing && !wasKing)
+        material += (whiteTurn ? 1 : -1) * (KING_VALUE - PAWN_VALUE);
+
+    hash ^= zobrist::pieceKey(from, whiteTurn, wasKing);
+    hash ^= zobrist::pieceKey(to, whiteTurn, isKing);
+
+    // Bicie - wszystkie zbite figury naraz
+    Bitboard captured = move.captured();
+    while (captured) {
+        int sq = bb::popLsb(captured);
+        bool capturedKing = (pos.kings & bb::bit(sq)) != 0;
+        hash ^= zobrist::pieceKey(sq, !whiteTurn, capturedKing);
+        material += (whiteTurn ? 1 : -1) * (capturedKing ? KING_VALUE : PAWN_VALUE);
+    }
+    opp &= ~move.captured();
+    pos.kings &= ~move.captured();
+
+    return backup;
+}
+
+void GameState::undoMove(const MoveBackup& backup) {
+    pos = backup.before;
+    hash = backup.hashBefore;
+    material = backup.materialBefore;
+}
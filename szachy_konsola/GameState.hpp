@@ -0,0 +1,61 @@
+﻿#pragma once
+#include <cstdint>
+#include "Bitboard.hpp"
+#include "Move.hpp"
+#include "EvalWeights.hpp"
+
+// Warianty oceny do porównywania w turnieju (tools/Tournament.cpp). Standard = evaluate() z wagami
+// z EvalWeights.hpp; pozostałe mają stałe wagi niezależne od strojenia, więc są punktem odniesienia:
+// MaterialOnly - piony 100 i damki 200, Handcrafted - ręczna ocena sprzed strojenia (ten sam materiał
+// i kara za figurę pod biciem: 200 w liściu bez quiescence, 50 w stand-pat).
+enum class EvalVariant : uint8_t { Standard, MaterialOnly, Handcrafted };
+
+// Stan partii widziany przez reguły i AI: figury, klucz Zobrista i materiał.
+// Nie zawiera nic z UI (zaznaczenia, podpowiedzi, skoki w trakcie bicia), więc AI może liczyć na własnej kopii.
+class GameState {
+public:
+    // Wartości figur do licznika materiału - z wag oceny (EvalWeights.hpp)
+    static constexpr int PAWN_VALUE = EVAL_WEIGHTS[eval::Man];
+    static constexpr int KING_VALUE = EVAL_WEIGHTS[eval::King];
+    static_assert(PAWN_VALUE == 100, "pion to skala oceny (marginesy, okna aspiracyjne) - tune fit go nie stroi");
+    static_assert(KING_VALUE > PAWN_VALUE, "bez tego promocja obniża materiał i przeszukiwanie jej unika");
+
+    struct MoveBackup {
+        Position before;
+        uint64_t hashBefore;
+        int materialBefore;
+    };
+
+    Position pos;
+    uint64_t hash = 0; // Zobrist figur, aktualizowany przyrostowo
+    int material = 0;  // pionki i damki białych minus czarnych (PAWN/KING_VALUE), też przyrostowo
+
+    void clear();
+    void putPiece(int sq, bool white, bool king);
+    void removePiece(int sq);
+    uint64_t key(bool whiteTurn) const;
+
+    bool hasCapture(bool whiteTurn) const;
+    bool canCaptureFrom(int sq, bool whiteTurn) const; // czy figura z pola sq ma bicie (kontynuacja skoku)
+    bool canBeCaptured(int row, int col, bool isWhite) const;
+    // Pola, na które figura z sq może pójść w tej turze (podpowiedzi w UI): gdy jest bicie albo trwa seria skoków
+    // (continuing), tylko lądowania skoków; figura bez bicia, gdy bije inna, nie ma żadnego
+    Bitboard targetsFrom(int sq, bool whiteTurn, bool continuing) const;
+    Bitboard threatened() const; // figury obu stron, które przeciwnik może zbić (canBeCaptured dla wszystkich naraz)
+    int evaluate() const;        // materiał z licznika + kara za figury pod biciem + cechy pozycyjne
+    int evaluateFull() const;    // to samo liczone od zera z eval::extract - w Debug evaluate() sprawdza się z tym
+    // Ocena w wariancie; quiet = stand-pat w quiescence (strona na ruchu nie ma bicia, więc pod biciem są
+    // tylko jej figury). Standard to zawsze evaluate() - wagi są strojone właśnie na spokojnych pozycjach.
+    int evaluate(EvalVariant variant, bool quiet) const;
+    // Dopisuje do moves całe tury: przy biciu każdą pełną drogę skoków (bicie jest obowiązkowe),
+    // inaczej ruchy o jedno pole
+    void generateMoves(bool whiteTurn, MoveList& moves) const;
+    bool hasMoves(bool whiteTurn) const; // bez generowania listy
+    bool isGameOver(bool whiteTurn) const { return !hasMoves(whiteTurn); }
+    MoveBackup applyMove(Move move, bool whiteTurn);
+    void undoMove(const MoveBackup& backup);
+
+private:
+    int positional() const; // cechy poza materiałem i zagrożeniami (Advanced, BackRank, Center)
+    void addCaptures(MoveList& moves, const Position& p, int start, int sq, bool whiteTurn, bool king, Bitboard captured) const;
+};
@@ -0,0 +1,80 @@
+﻿#pragma once
+#include <cstdint>
+#include <type_traits>
+#include "Bitboard.hpp"
+
+// Geometria planszy jako parametr szablonu: tablice sąsiadów, skoków i pól promocji liczone w czasie kompilacji.
+// Pola liczone są tak samo jak w Bitboard.hpp dla każdego rozmiaru: wierszami od góry, tylko ciemne pola
+// ((row + col) nieparzyste), więc na 8x8 indeksy i kierunki są te same co w bb::, a na 10x10
+// numer pola PDN (1..50) to indeks + 1. Gra (GameState, Board) używa Board8; 10x10 ma tylko
+// referencyjny generator w tools/Rules.hpp.
+namespace rules {
+
+    // Pole docelowe [pole][kierunek], -1 poza planszą; liczone w czasie kompilacji
+    template <int SQUARES>
+    struct SquareTable {
+        int8_t to[SQUARES][4] = {};
+
+        constexpr int operator()(int sq, int dir) const { return to[sq][dir]; }
+    };
+
+    template <int N>
+    struct Geometry {
+        static_assert(N % 2 == 0 && N >= 4, "plansza ma parzysty rozmiar");
+
+        static constexpr int SIZE = N;
+        static constexpr int PER_ROW = N / 2;
+        static constexpr int SQUARES = N * N / 2;
+        using Bits = std::conditional_t<(SQUARES <= 32), uint32_t, uint64_t>;
+
+        static constexpr int square(int row, int col) {
+            if (row < 0 || row >= N || col < 0 || col >= N || (row + col) % 2 == 0) return -1;
+            return row * PER_ROW + col / 2;
+        }
+        static constexpr int row(int sq) { return sq / PER_ROW; }
+        static constexpr int col(int sq) { return 2 * (sq % PER_ROW) + (row(sq) % 2 == 0 ? 1 : 0); }
+        static constexpr Bits bit(int sq) { return Bits(1) << sq; }
+
+        // Kierunki w kolejności bb::Direction; "up" = w stronę wiersza 0
+        static constexpr int DROW[4] = { -1, -1, 1, 1 };
+        static constexpr int DCOL[4] = { -1, 1, -1, 1 };
+    };
+
+    template <typename G>
+    constexpr SquareTable<G::SQUARES> makeTable(int distance) {
+        SquareTable<G::SQUARES> t;
+        for (int sq = 0; sq < G::SQUARES; ++sq)
+            for (int d = 0; d < 4; ++d)
+                t.to[sq][d] = int8_t(G::square(G::row(sq) + distance * G::DROW[d], G::col(sq) + distance * G::DCOL[d]));
+        return t;
+    }
+
+    template <typename G>
+    constexpr typename G::Bits rowMask(int r) {
+        typename G::Bits b = 0;
+        for (int i = 0; i < G::PER_ROW; ++i)
+            b |= G::bit(r * G::PER_ROW + i);
+        return b;
+    }
+
+    template <typename G> inline constexpr SquareTable<G::SQUARES> STEP = makeTable<G>(1); // sąsiad po przekątnej
+    template <typename G> inline constexpr SquareTable<G::SQUARES> JUMP = makeTable<G>(2); // lądowanie skoku nad sąsiadem
+    // Pola promocji strony: [white] - czarne na ostatnim wierszu, białe na wierszu 0
+    template <typename G> inline constexpr typename G::Bits PROMOTION[2] = { rowMask<G>(G::SIZE - 1), rowMask<G>(0) };
+
+    // Tablice 8x8 muszą się zgadzać z przesunięciami bitboardów, na których stoi GameState
+    constexpr bool matchesBitboard() {
+        using G = Geometry<8>;
+        for (int sq = 0; sq < G::SQUARES; ++sq) {
+            for (int d = 0; d < 4; ++d) {
+                int s = STEP<G>(sq, d), j = JUMP<G>(sq, d);
+                if (bb::shift(bb::bit(sq), d) != (s < 0 ? 0 : bb::bit(s))) return false;
+                if (bb::shift(bb::shift(bb::bit(sq), d), d) != (j < 0 ? 0 : bb::bit(j))) return false;
+            }
+        }
+        return PROMOTION<G>[1] == bb::ROW_0 && PROMOTION<G>[0] == bb::ROW_7;
+    }
+    static_assert(matchesBitboard(), "geometria 8x8 rozjechała się z Bitboard.hpp");
+
+    using Board8 = Geometry<8>; // plansza GameState i Board
+}
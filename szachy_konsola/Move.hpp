@@ -0,0 +1,71 @@
+﻿#pragma once
+#include <cstdint>
+#include <cassert>
+#include "Bitboard.hpp"
+
+// Ruch całej tury: skąd, dokąd i wszystkie zbite figury (bicie wielokrotne to jeden ruch).
+// Skąd/dokąd i flagi mieszczą się w 16 bitach (packed()) - tyle trzymają TT, historia i zabójcy;
+// zbite pola dochodzą jako osobny bitboard.
+// Move() = brak ruchu.
+class Move {
+public:
+    constexpr Move() = default;
+    constexpr Move(int from, int to, Bitboard captured = 0, bool promotes = false)
+        : data(uint16_t(from | (to << 5) | (captured ? 1 << 10 : 0) | (promotes ? 1 << 11 : 0))), capturedMask(captured) {}
+
+    constexpr int from() const { return data & 31; }
+    constexpr int to() const { return (data >> 5) & 31; }
+    constexpr bool isCapture() const { return (data & (1 << 10)) != 0; }
+    constexpr bool promotes() const { return (data & (1 << 11)) != 0; } // pion kończy turę jako damka
+    constexpr Bitboard captured() const { return capturedMask; }
+    constexpr bool isNull() const { return data == 0; }
+    constexpr uint16_t packed() const { return data; }
+
+    // Ta sama tura skąd/dokąd (różne drogi bicia mogą mieć te same końce)
+    constexpr bool sameSquares(Move other) const { return from() == other.from() && to() == other.to(); }
+
+    constexpr bool operator==(Move other) const { return data == other.data && capturedMask == other.capturedMask; }
+    constexpr bool operator!=(Move other) const { return !(*this == other); }
+
+private:
+    uint16_t data = 0;
+    Bitboard capturedMask = 0;
+};
+
+// Lista ruchów o stałej pojemności na stosie - generator nie alokuje.
+// Ruchów cichych jest najwyżej 12 figur * 4 kierunki = 48; dróg bicia w praktyce dużo mniej,
+// ale liczby dróg bicia damek nie da się łatwo ograniczyć - ruch ponad CAPACITY przepada (także w Release,
+// gdzie nie ma assert) i lista zapamiętuje to w truncated().
+class MoveList {
+public:
+    static constexpr int CAPACITY = 128;
+
+    MoveList() {} // bez zerowania tablicy - lista powstaje w każdym węźle przeszukiwania
+
+    void add(Move m) {
+        assert(count < CAPACITY);
+        if (count < CAPACITY) moves[count++] = m;
+        else overflowed = true;
+    }
+    void clear() {
+        count = 0;
+        overflowed = false;
+    }
+
+    int size() const { return count; }
+    bool truncated() const { return overflowed; } // część ruchów się nie zmieściła
+    bool empty() const { return count == 0; }
+
+    Move& operator[](int i) { return moves[i]; }
+    Move operator[](int i) const { return moves[i]; }
+
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+
+private:
+    union { Move moves[CAPACITY]; }; // unia, żeby konstruktor Move() nie wypełniał całej tablicy
+    int count = 0;
+    bool overflowed = false;
+};
@@ -0,0 +1,149 @@
+﻿#include "Notation.hpp"
+#include "Scenarios.hpp"
+#include <sstream>
+#include <vector>
+
+namespace {
+    std::vector<std::string> split(const std::string& text, char separator) {
+        std::vector<std::string> parts;
+        std::stringstream ss(text);
+        std::string part;
+        while (std::getline(ss, part, separator))
+            parts.push_back(part);
+        return parts;
+    }
+
+    // Numer pola 1..32; -1 dla czegokolwiek innego
+    int parseSquare(const std::string& text) {
+        if (text.empty() || text.size() > 2) return -1;
+        int n = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return -1;
+            n = n * 10 + (c - '0');
+        }
+        return (n >= 1 && n <= bb::SQUARES) ? n - 1 : -1;
+    }
+
+    void appendPieces(std::string& fen, Bitboard pieces, Bitboard kings) {
+        bool first = true;
+        while (pieces) {
+            int sq = bb::popLsb(pieces);
+            if (!first) fen += ',';
+            if (kings & bb::bit(sq)) fen += 'K';
+            fen += std::to_string(sq + 1);
+            first = false;
+        }
+    }
+}
+
+std::string notation::toFen(const GameState& state, bool whiteTurn) {
+    const Position& p = state.pos;
+    std::string fen = whiteTurn ? "W:W" : "B:W";
+    appendPieces(fen, p.white, p.kings);
+    fen += ":B";
+    appendPieces(fen, p.black, p.kings);
+    return fen;
+}
+
+std::string notation::startFen() {
+    GameState state;
+    scenario::startPosition(state);
+    return toFen(state, true);
+}
+
+bool notation::parseFen(const std::string& fen, GameState& state, bool& whiteTurn) {
+    std::vector<std::string> fields = split(fen, ':');
+    if (fields.empty() || (fields[0] != "W" && fields[0] != "B"))
+        return false;
+
+    GameState parsed;
+    for (size_t i = 1; i < fields.size(); ++i) {
+        const std::string& field = fields[i];
+        if (field.empty() || (field[0] != 'W' && field[0] != 'B'))
+            return false;
+        bool white = field[0] == 'W';
+
+        for (std::string item : split(field.substr(1), ',')) {
+            if (item.empty()) continue; // "W:W:B1" - strona bez figur
+            bool king = item[0] == 'K';
+            if (king) item.erase(0, 1);
+
+            // PDN pozwala też na zakresy: "21-32"
+            size_t dash = item.find('-');
+            int first = parseSquare(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : parseSquare(item.substr(dash + 1));
+            if (first < 0 || last < first)
+                return false;
+
+            for (int sq = first; sq <= last; ++sq) {
+                if (parsed.pos.occupied() & bb::bit(sq))
+                    return false;
+                parsed.putPiece(sq, white, king);
+            }
+        }
+    }
+
+    state = parsed;
+    whiteTurn = fields[0] == "W";
+    return true;
+}
+
+std::string notation::moveToString(const GameState& state, bool whiteTurn, Move move) {
+    std::string text = std::to_string(move.from() + 1) + (move.isCapture() ? 'x' : '-') + std::to_string(move.to() + 1);
+    if (!move.isCapture())
+        return text;
+
+    // Zbite figury dopisujemy tylko wtedy, gdy inne bicie ma te same pola
+    MoveList moves;
+    state.generateMoves(whiteTurn, moves);
+    bool ambiguous = false;
+    for (Move m : moves)
+        if (m.sameSquares(move) && m != move)
+            ambiguous = true;
+    if (!ambiguous)
+        return text;
+
+    Bitboard captured = move.captured();
+    char separator = ':';
+    while (captured) {
+        text += separator;
+        text += std::to_string(bb::popLsb(captured) + 1);
+        separator = ',';
+    }
+    return text;
+}
+
+Move notation::parseMove(const GameState& state, bool whiteTurn, const std::string& text) {
+    std::string squares = text, capturedList;
+    size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+        squares = text.substr(0, colon);
+        capturedList = text.substr(colon + 1);
+    }
+
+    // "22x15x6" z polami pośrednimi też przyjmujemy - liczy się pierwsze i ostatnie
+    size_t firstSep = squares.find_first_of("-x");
+    size_t lastSep = squares.find_last_of("-x");
+    if (firstSep == std::string::npos)
+        return Move();
+    int from = parseSquare(squares.substr(0, firstSep));
+    int to = parseSquare(squares.substr(lastSep + 1));
+    if (from < 0 || to < 0)
+        return Move();
+
+    Bitboard captured = 0;
+    for (const std::string& item : split(capturedList, ',')) {
+        int sq = parseSquare(item);
+        if (sq < 0)
+            return Move();
+        captured |= bb::bit(sq);
+    }
+
+    MoveList moves;
+    state.generateMoves(whiteTurn, moves);
+    for (Move m : moves) {
+        if (m.from() == from && m.to() == to && (!captured || m.captured() == captured))
+            return m;
+    }
+    return Move();
+}
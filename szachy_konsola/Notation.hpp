@@ -0,0 +1,19 @@
+﻿#pragma once
+#include <string>
+#include "GameState.hpp"
+
+// Zapis pozycji i ruchów dla protokołu tekstowego i narzędzi.
+// Pola mają numery 1..32 jak w PDN: numer = indeks bitboardu + 1, więc 1-4 to górny wiersz
+// (tam promują się białe), a białe zaczynają na 21-32.
+//
+// Pozycja (FEN): "W:W21,22,K30:B1,2,3" - strona na ruchu, potem figury obu stron, K = damka.
+// Ruch: "22-18" (cichy) albo "22x13" (bicie, także wielokrotne - tylko pole startowe i końcowe).
+// Gdy kilka bić ma te same pola, po ':' dochodzi lista zbitych figur: "22x13:17,18".
+namespace notation {
+    std::string toFen(const GameState& state, bool whiteTurn);
+    bool parseFen(const std::string& fen, GameState& state, bool& whiteTurn); // false = błędny zapis, stan bez zmian
+    std::string startFen();
+
+    std::string moveToString(const GameState& state, bool whiteTurn, Move move); // stan sprzed ruchu
+    Move parseMove(const GameState& state, bool whiteTurn, const std::string& text); // isNull() = błędny albo nielegalny
+}
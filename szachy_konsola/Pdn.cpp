@@ -0,0 +1,222 @@
+﻿#include "Pdn.hpp"
+
+namespace {
+    bool isResult(const std::string& token) {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*"
+            || token == "2-0" || token == "0-2" || token == "1-1" || token == "0-0";
+    }
+
+    bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+    // [Klucz "wartość"]; false = to nie jest linia nagłówka
+    bool parseTag(const std::string& line, std::string& key, std::string& value) {
+        size_t open = line.find('[');
+        if (open == std::string::npos) return false;
+        size_t quote = line.find('"', open);
+        if (quote == std::string::npos) return false;
+
+        key = line.substr(open + 1, quote - open - 1);
+        while (!key.empty() && isSpace(key.back())) key.pop_back();
+
+        value.clear();
+        for (size_t i = quote + 1; i < line.size() && line[i] != '"'; ++i) {
+            if (line[i] == '\\' && i + 1 < line.size()) ++i;
+            value += line[i];
+        }
+        return !key.empty();
+    }
+
+    // Numer ruchu ("12." albo "12...") przed ruchem i znaki oceny za nim
+    std::string stripMove(const std::string& token) {
+        size_t dot = token.find_last_of('.');
+        std::string move = dot == std::string::npos ? token : token.substr(dot + 1);
+        while (!move.empty() && (move.back() == '!' || move.back() == '?'))
+            move.pop_back();
+        return move;
+    }
+
+    std::string escape(const std::string& value) {
+        std::string out;
+        for (char c : value) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+}
+
+std::string pdn::Game::tag(const std::string& key) const {
+    for (const auto& t : tags)
+        if (t.first == key) return t.second;
+    return std::string();
+}
+
+void pdn::Game::setTag(const std::string& key, const std::string& value) {
+    for (auto& t : tags) {
+        if (t.first == key) {
+            t.second = value;
+            return;
+        }
+    }
+    tags.emplace_back(key, value);
+}
+
+bool pdn::Reader::next(Game& game) {
+    game = Game();
+    bool started = false;  // cokolwiek z tej partii już przeczytane
+    bool movetext = false; // za nagłówkami
+    bool inComment = false;
+    int variation = 0;     // głębokość (...) - wszystko w środku pomijamy
+    std::string comment, token;
+
+    auto addComment = [&]() {
+        if (variation > 0 || comment.empty()) return;
+        std::string& target = game.moves.empty() ? game.preface : game.comments.back();
+        target += (target.empty() ? "" : " ") + comment;
+    };
+
+    // true = token zakończył partię
+    auto flush = [&]() {
+        if (token.empty()) return false;
+        std::string t;
+        t.swap(token);
+        if (isResult(t)) {
+            game.result = t;
+            return true;
+        }
+        if (t[0] == '$') return false;
+        std::string move = stripMove(t);
+        if (!move.empty()) {
+            game.moves.push_back(move);
+            game.comments.emplace_back();
+        }
+        return false;
+    };
+
+    std::string line;
+    for (;;) {
+        if (hasPending) {
+            line.swap(pending);
+            hasPending = false;
+        }
+        else if (std::getline(in, line)) {
+            ++lineNumber;
+        }
+        else {
+            flush();
+            return started;
+        }
+
+        size_t first = line.find_first_not_of(" \t\r");
+        if (!inComment && first != std::string::npos && line[first] == '[') {
+            // Nagłówek po ruchach to już następna partia (bez wyniku na końcu poprzedniej)
+            if (movetext) {
+                pending = line;
+                hasPending = true;
+                flush();
+                return true;
+            }
+            std::string key, value;
+            if (parseTag(line, key, value)) {
+                game.tags.emplace_back(key, value);
+                started = true;
+            }
+            continue;
+        }
+
+        for (char c : line) {
+            if (inComment) {
+                if (c == '}') {
+                    inComment = false;
+                    addComment();
+                }
+                else {
+                    comment += (c == '\r' || c == '\n') ? ' ' : c;
+                }
+                continue;
+            }
+            if (isSpace(c) || c == '{' || c == '(' || c == ')') {
+                if (variation == 0 && flush()) return true;
+                token.clear();
+            }
+            if (isSpace(c))
+                continue;
+            if (c == ';')
+                break; // komentarz do końca linii
+
+            movetext = started = true;
+            if (c == '{') {
+                inComment = true;
+                comment.clear();
+            }
+            else if (c == '(') {
+                ++variation;
+            }
+            else if (c == ')') {
+                if (variation > 0) --variation;
+            }
+            else {
+                token += c;
+            }
+        }
+        if (inComment) comment += ' ';
+        else if (variation == 0 && flush()) return true;
+        token.clear();
+    }
+}
+
+void pdn::write(std::ostream& out, const Game& game) {
+    constexpr size_t LINE_WIDTH = 79;
+
+    for (const auto& t : game.tags)
+        out << '[' << t.first << " \"" << escape(t.second) << "\"]\n";
+    if (!game.tags.empty())
+        out << '\n';
+
+    std::string line;
+    auto put = [&](const std::string& word) {
+        if (!line.empty() && line.size() + 1 + word.size() > LINE_WIDTH) {
+            out << line << '\n';
+            line.clear();
+        }
+        line += (line.empty() ? "" : " ") + word;
+    };
+    auto putComment = [&](const std::string& text) {
+        // Komentarz łamany po słowach jak reszta ruchów
+        std::string word;
+        std::string pending = "{";
+        for (size_t i = 0; i <= text.size(); ++i) {
+            if (i == text.size() || isSpace(text[i])) {
+                if (!word.empty()) {
+                    put(pending + word);
+                    pending.clear();
+                    word.clear();
+                }
+            }
+            else {
+                word += text[i] == '}' ? ')' : text[i];
+            }
+        }
+        line += pending.empty() ? "}" : "{}";
+    };
+
+    if (!game.preface.empty())
+        putComment(game.preface);
+
+    // Numer ruchu przed ruchem białych; partia od pozycji z czarnymi na ruchu zaczyna się od "1..."
+    std::string fen = game.tag("FEN");
+    bool whiteFirst = fen.empty() || (fen[0] != 'B' && fen[0] != 'b');
+    for (size_t i = 0; i < game.moves.size(); ++i) {
+        size_t ply = i + (whiteFirst ? 0 : 1);
+        if (ply % 2 == 0)
+            put(std::to_string(ply / 2 + 1) + ". " + game.moves[i]);
+        else if (i == 0)
+            put("1... " + game.moves[i]);
+        else
+            put(game.moves[i]);
+        if (i < game.comments.size() && !game.comments[i].empty())
+            putComment(game.comments[i]);
+    }
+    put(game.result);
+    out << line << "\n\n";
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Partie w PDN: nagłówki [Klucz "wartość"], potem ruchy w zapisie z Notation.hpp ("22-18", "22x15x6"),
+// numery ruchów, komentarze {...} i wynik (1-0, 0-1, 1/2-1/2, 2-0, 0-2, 1-1, *). Warianty (...),
+// NAG-i ($n) i znaki oceny (!, ?) są pomijane. Pozycja startowa z nagłówka FEN, bez niego standardowa.
+//
+// Reader czyta strumień partia po partii - w pamięci jest tylko bieżąca partia,
+// więc plik może mieć dowolny rozmiar.
+namespace pdn {
+    struct Game {
+        std::vector<std::pair<std::string, std::string>> tags; // w kolejności z pliku
+        std::string preface;               // komentarz przed pierwszym ruchem
+        std::vector<std::string> moves;
+        std::vector<std::string> comments; // komentarz po ruchu i ("" = brak), tyle samo co moves
+        std::string result = "*";
+
+        std::string tag(const std::string& key) const; // "" = brak
+        void setTag(const std::string& key, const std::string& value);
+    };
+
+    class Reader {
+    public:
+        explicit Reader(std::istream& in) : in(in) {}
+        bool next(Game& game); // false = koniec pliku
+        size_t line() const { return lineNumber; }
+
+    private:
+        std::istream& in;
+        size_t lineNumber = 0;
+        std::string pending; // nagłówek następnej partii, przeczytany przy szukaniu końca bieżącej
+        bool hasPending = false;
+    };
+
+    void write(std::ostream& out, const Game& game); // z pustą linią po partii
+}
@@ -0,0 +1,90 @@
+﻿#include "Scenarios.hpp"
+
+namespace {
+    void put(GameState& state, int row, int col, bool white, bool king) {
+        state.putPiece(bb::square(row, col), white, king);
+    }
+}
+
+void scenario::startPosition(GameState& state) {
+    state.clear();
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 8; ++j)
+            if ((i + j) % 2 == 1)
+                put(state, i, j, false, false);
+
+    for (int i = 5; i < 8; ++i)
+        for (int j = 0; j < 8; ++j)
+            if ((i + j) % 2 == 1)
+                put(state, i, j, true, false);
+}
+
+bool scenario::load(GameState& state, int id) {
+    state.clear();
+
+    switch (id) {
+    case 1: // Bicie obowiązkowe — inny pionek nie może się ruszyć
+        put(state, 5, 2, true, false);
+        put(state, 6, 7, true, false);
+        put(state, 4, 3, false, false);
+        break;
+
+    case 2: // Bicie wielokrotne
+        put(state, 5, 2, true, false);
+        put(state, 4, 3, false, false);
+        put(state, 4, 5, false, false);
+        put(state, 2, 3, false, false);
+        break;
+
+    // Scenariusze 3-7 były ustawione na jasnych polach - odbite w poziomie na ciemne
+    case 3: // Próba ruchu pionka w tył (niedozwolona)
+        put(state, 4, 3, true, false);
+        break;
+
+    case 4: // Bicie do tyłu dozwolone
+        put(state, 4, 3, true, false);
+        put(state, 3, 4, false, false);
+        break;
+
+    case 5: // Promocja na damkę
+        put(state, 1, 5, true, false);
+        break;
+
+    case 6: // Ruch damki w dowolnym kierunku
+        put(state, 4, 3, true, true);
+        break;
+
+    case 7: // Bicie damką w tył i przód
+        put(state, 4, 3, true, true);
+        put(state, 3, 4, false, false);
+        put(state, 5, 2, false, false);
+        break;
+
+    case 8: // Tylko jeden pionek może bić — inne nie mogą się ruszyć
+        put(state, 5, 0, true, false);
+        put(state, 5, 6, true, false);
+        put(state, 4, 1, false, false);
+        break;
+    case 9: // Tylko jeden pionek może kontynuować bicie
+        put(state, 4, 1, true, false);
+        put(state, 5, 6, true, false);
+        put(state, 3, 2, false, false);
+        put(state, 1, 4, false, false);
+        put(state, 4, 5, false, false);
+        break;
+    case 10: // Błąd: wybrany pionek może ruszyć się bez bicia
+        put(state, 5, 2, true, false);   // Bije w prawo
+        put(state, 4, 3, false, false);
+        put(state, 5, 6, true, false);   // Ten pionek nie może się ruszyć
+        break;
+
+    case 11: // AI może wygrać ruchem bicia
+        put(state, 2, 3, false, false); // AI (Black) pionek
+        put(state, 3, 4, true, false); // Gracz (White) pionek
+        break;
+
+    default:
+        return false;
+    }
+    return true;
+}
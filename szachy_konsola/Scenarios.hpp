@@ -0,0 +1,10 @@
+﻿#pragma once
+#include "GameState.hpp"
+
+// Pozycje testowe bez UI - używa ich Board::loadScenario i narzędzia (perft)
+namespace scenario {
+    constexpr int COUNT = 11; // scenariusze mają numery 1..COUNT
+
+    void startPosition(GameState& state);
+    bool load(GameState& state, int id); // false dla nieznanego numeru (plansza zostaje pusta)
+}
@@ -0,0 +1,502 @@
+﻿#include "Search.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <climits>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Progi punktacji w orderMoves - historia jest przycinana poniżej KILLER_SCORE
+    constexpr int HASH_MOVE_SCORE = 1 << 30;
+    constexpr int CAPTURE_SCORE = 1 << 24;
+    constexpr int KILLER_SCORE = 1 << 22;
+    constexpr int HISTORY_LIMIT = KILLER_SCORE - 2;
+
+    // Redukcje późnych ruchów: ruch cichy od LMR_MIN_MOVE na liście, przy głębokości co najmniej LMR_MIN_DEPTH,
+    // liczony jest o poziom płycej; jeśli mimo to poprawia wynik, liczymy go jeszcze raz na pełną głębokość
+    constexpr int LMR_MIN_DEPTH = 3;
+    constexpr int LMR_MIN_MOVE = 3;
+
+    // Okno aspiracyjne wokół wyniku poprzedniej iteracji; po wyjściu poza okno rośnie 4x,
+    // a powyżej ASPIRATION_MAX liczymy już z pełnym oknem
+    constexpr int ASPIRATION_MIN_DEPTH = 4;
+    constexpr int ASPIRATION_WINDOW = GameState::PAWN_VALUE / 4;
+    constexpr int ASPIRATION_MAX = GameState::PAWN_VALUE * 8;
+
+    bool isDecisive(int score) { return score > TB_WIN_SCORE / 2 || score < -TB_WIN_SCORE / 2; }
+}
+
+void Search::Worker::clearOrdering() {
+    for (auto& k : killers)
+        k[0] = k[1] = Move();
+    for (auto& row : history)
+        for (int& h : row)
+            h = 0;
+}
+
+void Search::Worker::orderMoves(MoveList& moves, int ply, Move ttMove) {
+    if (moves.size() < 2)
+        return;
+
+    // Bicie jest obowiązkowe, więc lista to albo same bicia, albo same ruchy ciche
+    bool captures = moves[0].isCapture();
+
+    int scores[MoveList::CAPACITY];
+    for (int i = 0; i < moves.size(); ++i) {
+        Move m = moves[i];
+
+        int score;
+        if (m.sameSquares(ttMove))
+            score = HASH_MOVE_SCORE;
+        else if (captures)
+            score = CAPTURE_SCORE + bb::popCount(m.captured()); // najpierw bicia zabierające najwięcej
+        else if (ply < MAX_PLY && killers[ply][0] == m)
+            score = KILLER_SCORE + 1;
+        else if (ply < MAX_PLY && killers[ply][1] == m)
+            score = KILLER_SCORE;
+        else
+            score = history[m.from()][m.to()];
+        scores[i] = score;
+    }
+
+    // Sortowanie przez wstawianie (stabilne, bez alokacji) - list jest kilka-kilkanaście ruchów
+    for (int i = 1; i < moves.size(); ++i) {
+        Move m = moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        for (; j >= 0 && scores[j] < score; --j) {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+        }
+        moves[j + 1] = m;
+        scores[j + 1] = score;
+    }
+}
+
+// Ruch cichy, który dał odcięcie: zabójca na tym poziomie i punkty w historii
+void Search::Worker::updateOrdering(Move move, int depth, int ply) {
+    if (move.isCapture())
+        return;
+
+    if (ply < MAX_PLY && killers[ply][0] != move) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    int& h = history[move.from()][move.to()];
+    h += depth * depth;
+    if (h > HISTORY_LIMIT) {
+        for (auto& row : history)
+            for (int& v : row)
+                v /= 2;
+    }
+}
+
+// Stop, zegar i limit węzłów sprawdzane co 1024 węzły; przerwany wynik i tak zostanie odrzucony
+void Search::Worker::pollStop() {
+    if ((nodes & 1023) == 0) {
+        if (owner->stopRequested.load(std::memory_order_relaxed) ||
+            owner->mainDone.load(std::memory_order_relaxed) ||
+            (owner->nodeLimit && nodes >= owner->nodeLimit) ||
+            (owner->timeLimited && std::chrono::steady_clock::now() >= owner->deadline))
+            aborted = true;
+    }
+}
+
+int Search::Worker::minimax(int depth, int ply, int alpha, int beta, bool maximizingPlayer, bool whiteTurn) {
+    ++nodes;
+    pollStop();
+    if (aborted)
+        return 0;
+
+    const int lossScore = whiteTurn ? INT_MIN + 1 : INT_MAX - 1;
+
+    // Baza końcówek zna dokładny wynik - dalej nie ma czego liczyć
+    const Tablebase* tables = owner->tablebase;
+    if (tables && bb::popCount(state.pos.occupied()) <= tables->maxPieces()) {
+        Tablebase::Entry entry;
+        if (tables->probe(state.pos, whiteTurn, entry)) {
+            ++tbHits;
+            if (entry.result == Tablebase::Result::Draw)
+                return 0;
+            int score = TB_WIN_SCORE - entry.distance;
+            bool whiteWins = (entry.result == Tablebase::Result::Win) == whiteTurn;
+            return whiteWins ? score : -score;
+        }
+    }
+
+    // Na liściu dogrywamy bicia, żeby nie oceniać pozycji w środku wymiany
+    if (depth == 0) {
+        if (owner->quiescence)
+            return quiesce(ply, alpha, beta, maximizingPlayer, whiteTurn);
+        return state.isGameOver(whiteTurn) ? lossScore : state.evaluate(owner->evalVariant, false);
+    }
+
+    // Tablica transpozycji: odcięcie albo przynajmniej ruch do sprawdzenia jako pierwszy
+    uint64_t key = state.key(whiteTurn);
+    int alphaOrig = alpha, betaOrig = beta;
+    Move ttMove;
+
+    TTEntry entry;
+    ++ttProbes;
+    if (owner->tt.probe(key, entry)) {
+        ++ttHits;
+        if (entry.from != TTEntry::NO_SQUARE)
+            ttMove = Move(entry.from, entry.to); // porównywane tylko skąd/dokąd
+
+        if (entry.depth >= depth) {
+            if (entry.bound == Bound::Exact)
+                return entry.score;
+            if (entry.bound == Bound::Lower)
+                alpha = std::max(alpha, entry.score);
+            else
+                beta = std::min(beta, entry.score);
+            if (beta <= alpha)
+                return entry.score;
+        }
+    }
+
+    // Brak ruchów = przegrana strony na ruchu
+    MoveList moves;
+    state.generateMoves(whiteTurn, moves);
+    if (moves.empty())
+        return lossScore;
+
+    orderMoves(moves, ply, ttMove);
+    ++interiorNodes;
+
+    int bestEval = maximizingPlayer ? INT_MIN : INT_MAX;
+    Move bestMove;
+
+    // Okno zerowe wokół bieżącej granicy strony na ruchu - wystarcza, żeby sprawdzić, czy ruch ją poprawia
+    auto child = [&](int childDepth, bool nullWindow) {
+        if (!nullWindow)
+            return minimax(childDepth, ply + 1, alpha, beta, !maximizingPlayer, !whiteTurn);
+        return maximizingPlayer ? minimax(childDepth, ply + 1, alpha, alpha + 1, false, !whiteTurn)
+                                : minimax(childDepth, ply + 1, beta - 1, beta, true, !whiteTurn);
+    };
+    auto improves = [&](int eval) { return maximizingPlayer ? eval > alpha : eval < beta; };
+    auto insideWindow = [&](int eval) { return eval > alpha && eval < beta; };
+
+    for (int i = 0; i < moves.size(); ++i) {
+        Move move = moves[i];
+        GameState::MoveBackup backup = state.applyMove(move, whiteTurn);
+        ++movesSearched;
+
+        // Następny gracz — przełącz kolor i zmniejsz głębokość.
+        // PVS: pierwszy ruch z pełnym oknem, kolejne z zerowym i ponownie, jeśli wejdą w okno.
+        bool nullWindow = owner->pvs && i > 0;
+        bool reduced = owner->lmr && depth >= LMR_MIN_DEPTH && i >= LMR_MIN_MOVE && !move.isCapture() && !move.promotes();
+
+        int eval = child(reduced ? depth - 2 : depth - 1, nullWindow);
+        if (reduced && !aborted && improves(eval))
+            eval = child(depth - 1, nullWindow);
+        if (nullWindow && !aborted && insideWindow(eval))
+            eval = child(depth - 1, false);
+
+        state.undoMove(backup);
+
+        // Przerwane przeszukanie - niepełnego wyniku nie zapisujemy do TT
+        if (aborted)
+            return 0;
+
+        if (maximizingPlayer ? eval > bestEval : eval < bestEval) {
+            bestEval = eval;
+            bestMove = move;
+        }
+
+        if (maximizingPlayer)
+            alpha = std::max(alpha, eval);
+        else
+            beta = std::min(beta, eval);
+
+        if (beta <= alpha) {
+            ++cutoffs;
+            if (i == 0) ++firstMoveCutoffs;
+            updateOrdering(move, depth, ply);
+            break;
+        }
+    }
+
+    Bound bound = Bound::Exact;
+    if (bestEval <= alphaOrig) bound = Bound::Upper;
+    else if (bestEval >= betaOrig) bound = Bound::Lower;
+    owner->tt.store(key, depth, bestEval, bound, bestMove.from(), bestMove.to());
+
+    return bestEval;
+}
+
+// Quiescence: za horyzontem tylko bicia. Bicie jest obowiązkowe, więc strona, która może bić,
+// nie ma stand-pat i musi sprawdzić każdą drogę bicia; bez bicia pozycja jest spokojna
+// i zostaje ocena statyczna. Wymiany kończą się same, bo każde bicie zdejmuje figury.
+// Liść z minimax jest już policzony w nodes - qNodes to tylko węzły za horyzontem.
+int Search::Worker::quiesce(int ply, int alpha, int beta, bool maximizingPlayer, bool whiteTurn) {
+    // Stand-pat: bez bicia zostaje ocena statyczna; zagrożone figury rozstrzygnie dopiero następny ruch
+    if (!state.hasCapture(whiteTurn)) {
+        if (!state.hasMoves(whiteTurn))
+            return whiteTurn ? INT_MIN + 1 : INT_MAX - 1;
+        return state.evaluate(owner->evalVariant, true);
+    }
+
+    MoveList moves;
+    state.generateMoves(whiteTurn, moves);
+    orderMoves(moves, ply, Move());
+
+    int bestEval = maximizingPlayer ? INT_MIN : INT_MAX;
+    for (Move move : moves) {
+        ++nodes;
+        ++qNodes;
+        pollStop();
+        if (aborted)
+            return 0;
+
+        GameState::MoveBackup backup = state.applyMove(move, whiteTurn);
+        int eval = quiesce(ply + 1, alpha, beta, !maximizingPlayer, !whiteTurn);
+        state.undoMove(backup);
+
+        if (aborted)
+            return 0;
+
+        if (maximizingPlayer) {
+            bestEval = std::max(bestEval, eval);
+            alpha = std::max(alpha, eval);
+        }
+        else {
+            bestEval = std::min(bestEval, eval);
+            beta = std::min(beta, eval);
+        }
+        if (beta <= alpha)
+            break;
+    }
+    return bestEval;
+}
+
+
+Move Search::Worker::findBestMove(bool whiteTurn, int depth, Move firstMove, int alpha, int beta) {
+    MoveList moves;
+    state.generateMoves(whiteTurn, moves);
+    if (moves.empty()) {
+        return Move(); // brak ruchów = koniec gry
+    }
+
+    // Najlepszy ruch z poprzedniej iteracji sprawdzamy jako pierwszy, potem bicia i historia
+    orderMoves(moves, 0, firstMove);
+
+    if (id != 0) {
+        // Wątki pomocnicze zaczynają od innych ruchów, żeby wypełniać TT tym, czego główny jeszcze nie liczył
+        std::rotate(moves.begin(), moves.begin() + id % moves.size(), moves.end());
+    }
+
+    const int alphaOrig = alpha, betaOrig = beta;
+    int bestScore = whiteTurn ? INT_MIN : INT_MAX;
+    Move bestMove;
+
+    // Granica z najlepszego dotąd ruchu przechodzi na następne (białe podnoszą alpha, czarne obniżają beta)
+    for (int i = 0; i < moves.size(); ++i) {
+        Move move = moves[i];
+        GameState::MoveBackup backup = state.applyMove(move, whiteTurn);
+
+        int score;
+        if (owner->pvs && i > 0) {
+            score = whiteTurn ? minimax(depth - 1, 1, alpha, alpha + 1, false, false)
+                              : minimax(depth - 1, 1, beta - 1, beta, true, true);
+            if (!aborted && score > alpha && score < beta)
+                score = minimax(depth - 1, 1, alpha, beta, !whiteTurn, !whiteTurn);
+        }
+        else {
+            score = minimax(depth - 1, 1, alpha, beta, !whiteTurn, !whiteTurn);
+        }
+        state.undoMove(backup);
+
+        // Liczą się tylko ruchy przeszukane do końca
+        if (aborted)
+            break;
+
+        if ((whiteTurn && score > bestScore) || (!whiteTurn && score < bestScore)) {
+            bestScore = score;
+            bestMove = move;
+        }
+
+        if (whiteTurn)
+            alpha = std::max(alpha, score);
+        else
+            beta = std::min(beta, score);
+        if (beta <= alpha)
+            break; // wynik poza oknem aspiracyjnym - iterate() liczy jeszcze raz z szerszym
+    }
+
+    rootScore = bestScore;
+    if (!aborted) {
+        Bound bound = Bound::Exact;
+        if (bestScore <= alphaOrig) bound = Bound::Upper;
+        else if (bestScore >= betaOrig) bound = Bound::Lower;
+        owner->tt.store(state.key(whiteTurn), depth, bestScore, bound, bestMove.from(), bestMove.to());
+    }
+
+    return bestMove;
+}
+
+
+SearchResult Search::Worker::iterate(bool whiteTurn, int maxDepth, Move firstMove) {
+    using Clock = std::chrono::steady_clock;
+
+    SearchResult result;
+    result.move = firstMove;
+    const stats::Counters before = stats::local; // liczniki są per wątek, więc przyrost to praca tego Workera
+
+    // Co drugi pomocnik liczy o jeden poziom głębiej niż główny wątek
+    int extra = (id % 2 == 1) ? 1 : 0;
+
+    for (int depth = 1 + extra; depth <= maxDepth; ++depth) {
+        // Okno aspiracyjne wokół poprzedniego wyniku; przy wyniku rozstrzygniętym pełne okno
+        int delta = ASPIRATION_WINDOW;
+        bool windowed = owner->aspiration && depth >= ASPIRATION_MIN_DEPTH && result.depth > 0 && !isDecisive(rootScore);
+        int alpha = windowed ? rootScore - delta : INT_MIN;
+        int beta = windowed ? rootScore + delta : INT_MAX;
+
+        for (;;) {
+            Move move = findBestMove(whiteTurn, depth, result.move, alpha, beta);
+
+            // Z przerwanej iteracji też bierzemy ruch, jeśli któryś został przeszukany do końca: poprzedni najlepszy
+            // szedł pierwszy, więc wynik nie jest gorszy. Nie bierzemy go, gdy wynik wypadł poza okno po stronie
+            // gorszej dla grającego (to tylko ograniczenie); wyjście po lepszej stronie to dobry ruch na powtórkę.
+            bool trusted = whiteTurn ? rootScore > alpha : rootScore < beta;
+            if (!move.isNull() && trusted)
+                result.move = move;
+            if (aborted || (rootScore > alpha && rootScore < beta))
+                break;
+
+            delta *= 4;
+            if (delta > ASPIRATION_MAX || isDecisive(rootScore)) {
+                alpha = INT_MIN;
+                beta = INT_MAX;
+            }
+            else {
+                if (rootScore <= alpha) alpha = rootScore - delta;
+                if (rootScore >= beta) beta = rootScore + delta;
+            }
+        }
+
+        if (aborted)
+            break;
+
+        result.depth = depth;
+        result.score = rootScore;
+
+        if (id == 0 && owner->onInfo) {
+            SearchInfo info;
+            info.depth = depth;
+            info.score = rootScore;
+            info.nodes = nodes;
+            info.ttProbes = ttProbes;
+            info.ttHits = ttHits;
+            info.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - owner->start).count();
+            info.pv = owner->principalVariation(state, whiteTurn, result.move, depth);
+            owner->onInfo(info);
+        }
+
+        // Wynik partii przesądzony - głębiej nic się nie zmieni
+        if (rootScore == INT_MIN + 1 || rootScore == INT_MAX - 1)
+            break;
+
+        // Następna iteracja trwa kilka razy dłużej - nie zaczynaj jej, jeśli minęła połowa czasu
+        if (id == 0 && owner->timeLimited && (Clock::now() - owner->start) * 2 > std::chrono::milliseconds(owner->timeMs))
+            break;
+    }
+
+    moveGenerations = stats::local.moveGenerations - before.moveGenerations;
+    evaluations = stats::local.evaluations - before.evaluations;
+    return result;
+}
+
+
+SearchResult Search::run(const GameState& root, bool whiteTurn, int maxDepth, int timeMs, uint64_t nodeLimit) {
+    using Clock = std::chrono::steady_clock;
+
+    this->timeMs = timeMs;
+    this->nodeLimit = nodeLimit;
+    timeLimited = timeMs > 0;
+    start = Clock::now();
+    deadline = start + std::chrono::milliseconds(timeMs);
+    mainDone = false;
+
+    SearchResult result;
+
+    MoveList moves;
+    root.generateMoves(whiteTurn, moves);
+    if (moves.empty())
+        return result;
+
+    result.move = moves[0];
+    if (moves.size() == 1) {
+        result.pv.push_back(result.move);
+        return result; // jedyny ruch (np. obowiązkowe bicie) - nie ma czego liczyć
+    }
+
+    std::vector<Worker> workers(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        workers[i].owner = this;
+        workers[i].id = i;
+        workers[i].state = root;
+        workers[i].clearOrdering();
+    }
+
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; ++i)
+        helpers.emplace_back([&workers, i, whiteTurn, maxDepth, first = result.move]() {
+            workers[i].iterate(whiteTurn, maxDepth, first);
+        });
+
+    result = workers[0].iterate(whiteTurn, maxDepth, result.move);
+
+    mainDone = true;
+    for (auto& t : helpers)
+        t.join();
+
+    for (const Worker& w : workers) {
+        result.nodes += w.nodes;
+        result.qNodes += w.qNodes;
+        result.ttProbes += w.ttProbes;
+        result.ttHits += w.ttHits;
+        result.tbHits += w.tbHits;
+        result.moveGenerations += w.moveGenerations;
+        result.evaluations += w.evaluations;
+    }
+    result.interiorNodes = workers[0].interiorNodes;
+    result.movesSearched = workers[0].movesSearched;
+    result.cutoffs = workers[0].cutoffs;
+    result.firstMoveCutoffs = workers[0].firstMoveCutoffs;
+    result.aborted = workers[0].aborted && stopRequested;
+    result.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    result.pv = principalVariation(root, whiteTurn, result.move, std::max(1, result.depth));
+    return result;
+}
+
+
+std::vector<Move> Search::principalVariation(const GameState& root, bool whiteTurn, Move first, int maxLength) const {
+    std::vector<Move> pv;
+    GameState state = root;
+    Move move = first;
+
+    while (!move.isNull() && int(pv.size()) < maxLength) {
+        pv.push_back(move);
+        state.applyMove(move, whiteTurn);
+        whiteTurn = !whiteTurn;
+
+        // TT pamięta tylko skąd/dokąd - szukamy pasującego legalnego ruchu
+        TTEntry entry;
+        move = Move();
+        if (!tt.probe(state.key(whiteTurn), entry) || entry.from == TTEntry::NO_SQUARE)
+            break;
+
+        MoveList moves;
+        state.generateMoves(whiteTurn, moves);
+        for (Move m : moves) {
+            if (m.sameSquares(Move(entry.from, entry.to))) {
+                move = m;
+                break;
+            }
+        }
+    }
+    return pv;
+}
@@ -0,0 +1,139 @@
+﻿#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "GameState.hpp"
+#include "TranspositionTable.hpp"
+#include "Tablebase.hpp"
+
+constexpr int MAX_SEARCH_DEPTH = 64; // limit iteracyjnego pogłębiania przy limicie czasu
+constexpr int MAX_PLY = MAX_SEARCH_DEPTH;
+
+// Wynik z bazy końcówek: wygrana minus dystans, żeby szybsza wygrana (i dłuższa obrona) była lepsza
+constexpr int TB_WIN_SCORE = 1 << 24;
+
+struct SearchResult {
+    Move move;          // isNull() = brak ruchu
+    int score = 0;      // wynik ostatniej pełnej iteracji (dodatni = lepiej dla białych)
+    int depth = 0;      // ostatnia pełna iteracja
+    uint64_t nodes = 0; // suma ze wszystkich wątków, razem z qNodes
+    uint64_t qNodes = 0; // węzły quiescence (dogrywanie bić za horyzontem)
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+    uint64_t tbHits = 0;
+    uint64_t moveGenerations = 0; // liczniki stats:: ze wszystkich wątków
+    uint64_t evaluations = 0;
+    int64_t timeMs = 0;
+    std::vector<Move> pv; // linia główna z TT, od move
+    bool aborted = false; // przerwane przez stop()
+
+    // Jakość kolejności ruchów: ile ruchów przeszukano na węzeł i jak często odcina już pierwszy
+    uint64_t interiorNodes = 0;
+    uint64_t movesSearched = 0;
+    uint64_t cutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;
+
+    double branchingFactor() const { return interiorNodes ? double(movesSearched) / double(interiorNodes) : 0.0; }
+    double firstMoveCutoffRate() const { return cutoffs ? double(firstMoveCutoffs) / double(cutoffs) : 0.0; }
+};
+
+// Postęp po każdej pełnej iteracji wątku głównego (protokół tekstowy wypisuje z tego linie info)
+struct SearchInfo {
+    int depth = 0;
+    int score = 0;      // dodatni = lepiej dla białych
+    uint64_t nodes = 0; // wątek główny
+    uint64_t ttProbes = 0; // j.w.
+    uint64_t ttHits = 0;
+    int64_t timeMs = 0; // od startu run()
+    std::vector<Move> pv; // najlepszy ruch i odpowiedzi odczytane z TT
+};
+
+// Przeszukiwanie minimax na własnej kopii stanu gry - nie dotyka planszy, na której gra UI.
+// Przy kilku wątkach działa jako Lazy SMP: każdy wątek liczy to samo drzewo od innego ruchu
+// w korzeniu, a wyniki wymieniają się przez wspólną tablicę transpozycji.
+class Search {
+public:
+    void resizeTT(size_t sizeMB) { tt.resize(sizeMB); }
+    void clearTT() { tt.clear(); }
+    void setThreads(int count) { threadCount = count < 1 ? 1 : count; }
+    int threads() const { return threadCount; }
+    void setEvalVariant(EvalVariant variant) { evalVariant = variant; }
+    void setTablebase(const Tablebase* tables) { tablebase = tables; } // nullptr = bez baz końcówek
+    void setQuiescence(bool enabled) { quiescence = enabled; } // false = ocena statyczna na liściach
+    // Przełączniki do pomiarów (bench features, turniej): PVS z oknem zerowym, okna aspiracyjne, redukcje późnych ruchów
+    void setPvs(bool enabled) { pvs = enabled; }
+    void setAspiration(bool enabled) { aspiration = enabled; }
+    void setLateMoveReductions(bool enabled) { lmr = enabled; }
+
+    // Iteracyjne pogłębianie: głębokość 1, 2, ... aż do maxDepth albo do końca czasu (timeMs > 0)
+    // lub limitu węzłów wątku głównego (nodeLimit > 0)
+    SearchResult run(const GameState& root, bool whiteTurn, int maxDepth, int timeMs, uint64_t nodeLimit = 0);
+
+    // Wołane z wątku przeszukiwania; pusta funkcja = bez raportów
+    void setInfoCallback(std::function<void(const SearchInfo&)> callback) { onInfo = std::move(callback); }
+
+    // Linia główna z TT: zaczyna od first i idzie po najlepszych ruchach, dopóki TT je zna
+    std::vector<Move> principalVariation(const GameState& root, bool whiteTurn, Move first, int maxLength) const;
+
+    // Bezpieczne z innego wątku; przeszukanie kończy się w ciągu ~1024 węzłów
+    void stop() { stopRequested = true; }
+    void clearStop() { stopRequested = false; }
+
+private:
+    // Jeden wątek przeszukiwania z własną kopią stanu i licznikami
+    struct Worker {
+        Search* owner = nullptr;
+        int id = 0; // 0 = wątek główny, tylko jego wynik jest zwracany
+        GameState state;
+
+        uint64_t nodes = 0;
+        uint64_t qNodes = 0;
+        uint64_t ttProbes = 0;
+        uint64_t ttHits = 0;
+        uint64_t tbHits = 0;
+        uint64_t interiorNodes = 0;
+        uint64_t movesSearched = 0;
+        uint64_t cutoffs = 0;
+        uint64_t firstMoveCutoffs = 0;
+        uint64_t moveGenerations = 0; // przyrost stats::local w iterate()
+        uint64_t evaluations = 0;
+        int rootScore = 0; // wynik ostatniego findBestMove (poza oknem alpha-beta tylko ograniczenie)
+        bool aborted = false;
+
+        // Kolejność ruchów: dwa ruchy-zabójcy na poziom i historia odcięć from/to (ruchy ciche)
+        Move killers[MAX_PLY][2];
+        int history[bb::SQUARES][bb::SQUARES];
+
+        void clearOrdering();
+        void orderMoves(MoveList& moves, int ply, Move ttMove);
+        void updateOrdering(Move move, int depth, int ply);
+
+        void pollStop();
+        int minimax(int depth, int ply, int alpha, int beta, bool maximizingPlayer, bool whiteTurn);
+        int quiesce(int ply, int alpha, int beta, bool maximizingPlayer, bool whiteTurn);
+        Move findBestMove(bool whiteTurn, int depth, Move firstMove, int alpha, int beta);
+        SearchResult iterate(bool whiteTurn, int maxDepth, Move firstMove);
+    };
+
+    TranspositionTable tt;
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<bool> mainDone{ false }; // wątek główny skończył - pomocnicze też kończą
+    int threadCount = 1;
+    EvalVariant evalVariant = EvalVariant::Standard;
+    bool quiescence = true;
+    bool pvs = true;
+    bool aspiration = true;
+    bool lmr = true;
+    const Tablebase* tablebase = nullptr;
+
+    std::function<void(const SearchInfo&)> onInfo;
+
+    bool timeLimited = false;
+    int timeMs = 0;
+    uint64_t nodeLimit = 0;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point deadline;
+};
@@ -0,0 +1,71 @@
+﻿#include "SearchService.hpp"
+#include <chrono>
+
+void SearchService::resizeTT(size_t sizeMB) {
+    cancel();
+    search.resizeTT(sizeMB);
+}
+
+void SearchService::setThreads(int count) {
+    cancel();
+    search.setThreads(count);
+}
+
+void SearchService::setTablebase(const Tablebase* tables) {
+    cancel();
+    search.setTablebase(tables);
+}
+
+void SearchService::start(const GameState& state, bool whiteTurn, int maxDepth, int timeMs) {
+    cancel();
+
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        latest = SearchInfo();
+    }
+    search.setInfoCallback([this](const SearchInfo& info) {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        latest = info;
+    });
+
+    // Flagę kasujemy tutaj, a nie w wątku, żeby cancel() zaraz po start() nie przepadł
+    search.clearStop();
+    pending = std::async(std::launch::async, [this, state, whiteTurn, maxDepth, timeMs]() {
+        return search.run(state, whiteTurn, maxDepth, timeMs);
+    });
+}
+
+void SearchService::ponder(const GameState& state, bool whiteTurn) {
+    start(state, whiteTurn, MAX_SEARCH_DEPTH, 0);
+    pondering = true;
+}
+
+SearchResult SearchService::stopPonder() {
+    if (!isPondering()) return SearchResult();
+
+    search.stop();
+    pondering = false;
+    return pending.get();
+}
+
+SearchInfo SearchService::progress() const {
+    std::lock_guard<std::mutex> lock(progressMutex);
+    return latest;
+}
+
+bool SearchService::isReady() const {
+    return pending.valid() && !pondering && pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+SearchResult SearchService::take() {
+    if (!isSearching()) return SearchResult();
+    return pending.get();
+}
+
+void SearchService::cancel() {
+    if (!pending.valid()) return;
+
+    search.stop();
+    pending.get();
+    pondering = false;
+}
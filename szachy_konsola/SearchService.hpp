@@ -0,0 +1,45 @@
+﻿#pragma once
+#include <future>
+#include <mutex>
+#include <cstddef>
+#include "Search.hpp"
+
+// Przeszukiwanie w tle: wątek roboczy dostaje własną kopię stanu, a UI odbiera wynik przez future,
+// więc okno dalej się rysuje i reaguje na Escape / zamknięcie w trakcie liczenia.
+class SearchService {
+public:
+    SearchService() = default;
+    SearchService(const SearchService&) = delete;
+    SearchService& operator=(const SearchService&) = delete;
+    ~SearchService() { cancel(); }
+
+    void resizeTT(size_t sizeMB); // przerywa trwające liczenie
+    void setThreads(int count);   // j.w.
+    void setTablebase(const Tablebase* tables); // j.w.; tablice muszą żyć dłużej niż serwis
+
+    void start(const GameState& state, bool whiteTurn, int maxDepth, int timeMs);
+    bool isSearching() const { return pending.valid() && !pondering; }
+    bool isReady() const;
+    SearchResult take(); // czeka, jeśli wynik nie jest jeszcze gotowy
+    void cancel();       // przerywa i porzuca wynik (także ponder)
+
+    // Ponder: w czasie ruchu człowieka liczy jego pozycję bez limitu, czyli wszystkie jego odpowiedzi.
+    // TT nie jest czyszczona między przeszukaniami, więc start() po ruchu człowieka zaczyna z gotowymi wpisami.
+    void ponder(const GameState& state, bool whiteTurn);
+    bool isPondering() const { return pending.valid() && pondering; }
+    SearchResult stopPonder(); // przerywa i zwraca, ile zdążył policzyć (move = przewidywany ruch człowieka)
+
+    int threads() const { return search.threads(); }
+
+    // Ostatnia pełna iteracja trwającego liczenia (także pondera) - dla nakładki ze statystykami;
+    // depth == 0, dopóki pierwsza iteracja się nie skończy
+    SearchInfo progress() const;
+
+private:
+    Search search;
+    std::future<SearchResult> pending;
+    bool pondering = false;
+
+    mutable std::mutex progressMutex; // latest pisze wątek przeszukiwania, czyta UI
+    SearchInfo latest;
+};
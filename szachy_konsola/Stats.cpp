@@ -0,0 +1,40 @@
+﻿#include "Stats.hpp"
+#include "Search.hpp"
+#include "Notation.hpp"
+#include <sstream>
+#include <iomanip>
+
+std::string stats::toJson(const SearchResult& result, const GameState& root, bool whiteTurn, int threads) {
+    std::ostringstream out;
+    // Zapis FEN i ruchów nie zawiera znaków wymagających escape'owania w JSON
+    out << "{\"build\":\"" << __DATE__ << " " << __TIME__ << "\""
+        << ",\"fen\":\"" << notation::toFen(root, whiteTurn) << "\""
+        << ",\"threads\":" << threads
+        << ",\"depth\":" << result.depth
+        << ",\"score\":" << result.score
+        << ",\"move\":\"" << (result.move.isNull() ? std::string() : notation::moveToString(root, whiteTurn, result.move)) << "\""
+        << ",\"pv\":[";
+
+    GameState state = root;
+    bool side = whiteTurn;
+    for (size_t i = 0; i < result.pv.size(); ++i) {
+        out << (i ? "," : "") << "\"" << notation::moveToString(state, side, result.pv[i]) << "\"";
+        state.applyMove(result.pv[i], side);
+        side = !side;
+    }
+
+    out << "],\"time_ms\":" << result.timeMs
+        << ",\"nodes\":" << result.nodes
+        << ",\"qnodes\":" << result.qNodes
+        << ",\"nps\":" << (result.timeMs > 0 ? result.nodes * 1000 / uint64_t(result.timeMs) : 0)
+        << ",\"move_generations\":" << result.moveGenerations
+        << ",\"evaluations\":" << result.evaluations
+        << ",\"tt_probes\":" << result.ttProbes
+        << ",\"tt_hits\":" << result.ttHits
+        << ",\"tb_hits\":" << result.tbHits
+        << std::fixed << std::setprecision(3)
+        << ",\"branching\":" << result.branchingFactor()
+        << ",\"first_move_cutoffs\":" << result.firstMoveCutoffRate()
+        << ",\"aborted\":" << (result.aborted ? "true" : "false") << "}";
+    return out.str();
+}
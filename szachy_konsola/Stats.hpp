@@ -0,0 +1,22 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include "GameState.hpp"
+
+struct SearchResult;
+
+// Liczniki instrumentacji silnika. Każdy wątek ma własne (thread_local), więc zliczanie w generatorze
+// i ocenie to zwykła inkrementacja bez atomowych operacji i bez dzielenia linii cache między wątkami.
+// Przeszukiwanie odczytuje przyrost na swoim wątku i dodaje go do SearchResult.
+namespace stats {
+    struct Counters {
+        uint64_t moveGenerations = 0; // wywołania GameState::generateMoves
+        uint64_t evaluations = 0;     // evaluate() we wszystkich wariantach
+    };
+
+    inline thread_local Counters local;
+
+    // Jedna linia JSON na przeszukanie (bez końca linii), do wykresów między wersjami i pozycjami:
+    // {"fen":...,"depth":...,"score":...,"move":...,"pv":[...],"nodes":...,"nps":..., ...}
+    std::string toJson(const SearchResult& result, const GameState& root, bool whiteTurn, int threads);
+}
@@ -0,0 +1,199 @@
+﻿#include "Tablebase.hpp"
+#include <cstring>
+#include <filesystem>
+
+namespace {
+    // C(n, k) dla n <= 32, k <= MAX_PIECES
+    struct Binomials {
+        uint64_t c[bb::SQUARES + 1][tb::MAX_PIECES + 1] = {};
+
+        constexpr Binomials() {
+            for (int n = 0; n <= bb::SQUARES; ++n) {
+                c[n][0] = 1;
+                for (int k = 1; k <= tb::MAX_PIECES && k <= n; ++k)
+                    c[n][k] = c[n - 1][k - 1] + (k <= n - 1 ? c[n - 1][k] : 0);
+            }
+        }
+    };
+    constexpr Binomials BINOM{};
+
+    uint64_t choose(int n, int k) {
+        return (k < 0 || n < k) ? 0 : BINOM.c[n][k];
+    }
+
+    // Numer pola wśród wolnych (pola zajęte przez occ są pomijane)
+    int compress(int sq, Bitboard occ) {
+        return sq - bb::popCount(occ & (bb::bit(sq) - 1));
+    }
+
+    int expand(int coord, Bitboard occ) {
+        Bitboard free = ~occ;
+        for (int i = 0; i < coord; ++i)
+            free &= free - 1;
+        return bb::lsb(free);
+    }
+
+    // Ranga zbioru w porządku colex: suma C(współrzędna, i) po kolejnych elementach
+    uint64_t rankMen(Bitboard set, int offset) {
+        uint64_t r = 0;
+        for (int i = 1; set; ++i)
+            r += choose(bb::popLsb(set) - offset, i);
+        return r;
+    }
+
+    uint64_t rankKings(Bitboard set, Bitboard occ) {
+        uint64_t r = 0;
+        for (int i = 1; set; ++i)
+            r += choose(compress(bb::popLsb(set), occ), i);
+        return r;
+    }
+
+    // Odwrotność rankingu: współrzędne od największej
+    template <typename ToSquare>
+    Bitboard unrank(uint64_t r, int k, int coords, ToSquare toSquare) {
+        Bitboard set = 0;
+        int c = coords - 1;
+        for (int i = k; i >= 1; --i) {
+            while (choose(c, i) > r) --c;
+            r -= choose(c, i);
+            set |= bb::bit(toSquare(c));
+            --c;
+        }
+        return set;
+    }
+
+    Bitboard reverse(Bitboard b) {
+        b = ((b >> 1) & 0x55555555u) | ((b & 0x55555555u) << 1);
+        b = ((b >> 2) & 0x33333333u) | ((b & 0x33333333u) << 2);
+        b = ((b >> 4) & 0x0F0F0F0Fu) | ((b & 0x0F0F0F0Fu) << 4);
+        b = ((b >> 8) & 0x00FF00FFu) | ((b & 0x00FF00FFu) << 8);
+        return (b >> 16) | (b << 16);
+    }
+
+    constexpr int MEN_SQUARES = bb::SQUARES - 4; // pion nigdy nie stoi na swoim polu promocji
+}
+
+std::string tb::Material::fileName() const {
+    return "tb_" + std::to_string(whiteMen) + std::to_string(whiteKings)
+        + std::to_string(blackMen) + std::to_string(blackKings) + ".bin";
+}
+
+tb::Material tb::materialOf(const Position& p) {
+    return {
+        bb::popCount(p.white & ~p.kings), bb::popCount(p.white & p.kings),
+        bb::popCount(p.black & ~p.kings), bb::popCount(p.black & p.kings)
+    };
+}
+
+Position tb::flip(const Position& p) {
+    Position f;
+    f.white = reverse(p.black);
+    f.black = reverse(p.white);
+    f.kings = reverse(p.kings);
+    return f;
+}
+
+uint64_t tb::tableSize(const Material& m) {
+    int free = bb::SQUARES - m.whiteMen - m.blackMen;
+    return choose(MEN_SQUARES, m.whiteMen) * choose(MEN_SQUARES, m.blackMen)
+        * choose(free, m.whiteKings) * choose(free - m.whiteKings, m.blackKings);
+}
+
+uint64_t tb::index(const Material& m, const Position& p) {
+    Bitboard whiteMen = p.white & ~p.kings, blackMen = p.black & ~p.kings;
+    Bitboard whiteKings = p.white & p.kings, blackKings = p.black & p.kings;
+    Bitboard men = whiteMen | blackMen;
+    int free = bb::SQUARES - m.whiteMen - m.blackMen;
+
+    uint64_t idx = rankMen(whiteMen, 4);
+    idx = idx * choose(MEN_SQUARES, m.blackMen) + rankMen(blackMen, 0);
+    idx = idx * choose(free, m.whiteKings) + rankKings(whiteKings, men);
+    idx = idx * choose(free - m.whiteKings, m.blackKings) + rankKings(blackKings, men | whiteKings);
+    return idx;
+}
+
+bool tb::unindex(const Material& m, uint64_t idx, Position& p) {
+    int free = bb::SQUARES - m.whiteMen - m.blackMen;
+    uint64_t nBlackKings = choose(free - m.whiteKings, m.blackKings);
+    uint64_t nWhiteKings = choose(free, m.whiteKings);
+    uint64_t nBlackMen = choose(MEN_SQUARES, m.blackMen);
+
+    uint64_t rBlackKings = idx % nBlackKings; idx /= nBlackKings;
+    uint64_t rWhiteKings = idx % nWhiteKings; idx /= nWhiteKings;
+    uint64_t rBlackMen = idx % nBlackMen; idx /= nBlackMen;
+
+    Bitboard whiteMen = unrank(idx, m.whiteMen, MEN_SQUARES, [](int c) { return c + 4; });
+    Bitboard blackMen = unrank(rBlackMen, m.blackMen, MEN_SQUARES, [](int c) { return c; });
+    if (whiteMen & blackMen)
+        return false;
+
+    Bitboard men = whiteMen | blackMen;
+    Bitboard whiteKings = unrank(rWhiteKings, m.whiteKings, free, [men](int c) { return expand(c, men); });
+    Bitboard blackKings = unrank(rBlackKings, m.blackKings, free - m.whiteKings,
+                                 [occ = men | whiteKings](int c) { return expand(c, occ); });
+
+    p.white = whiteMen | whiteKings;
+    p.black = blackMen | blackKings;
+    p.kings = whiteKings | blackKings;
+    return true;
+}
+
+Tablebase::Entry Tablebase::decode(uint8_t value) {
+    Entry e;
+    if (value == 0)
+        return e;
+    e.distance = value - 1;
+    e.result = (e.distance % 2 == 1) ? Result::Win : Result::Loss;
+    return e;
+}
+
+bool Tablebase::add(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < tb::HEADER_SIZE || std::memcmp(file.data(), "WTB1", 4) != 0)
+        return false;
+
+    const uint8_t* h = file.data();
+    tb::Material m{ h[4], h[5], h[6], h[7] };
+    if (m.whiteMen > tb::MAX_PIECES || m.whiteKings > tb::MAX_PIECES || m.blackMen > tb::MAX_PIECES || m.blackKings > tb::MAX_PIECES)
+        return false;
+
+    uint64_t count = 0;
+    for (int i = 7; i >= 0; --i)
+        count = count << 8 | h[8 + i]; // little-endian, jak zapisuje generator
+    if (count != tb::tableSize(m) || file.size() != tb::HEADER_SIZE + count)
+        return false;
+
+    tables[m.code()] = file.data() + tb::HEADER_SIZE;
+    if (m.total() > pieces)
+        pieces = m.total();
+    files.push_back(std::move(file)); // mapowanie się nie przesuwa, wskaźnik zostaje ważny
+    return true;
+}
+
+int Tablebase::load(const std::string& dir) {
+    std::error_code ec;
+    int loaded = 0;
+    for (const auto& item : std::filesystem::directory_iterator(dir, ec)) {
+        std::string name = item.path().filename().string();
+        if (name.rfind("tb_", 0) == 0 && item.path().extension() == ".bin" && add(item.path().string()))
+            ++loaded;
+    }
+    return loaded;
+}
+
+bool Tablebase::probe(const Position& p, bool whiteTurn, Entry& out) const {
+    if (!p.white || !p.black)
+        return false;
+
+    Position q = whiteTurn ? p : tb::flip(p);
+    tb::Material m = tb::materialOf(q);
+    if (m.total() > pieces)
+        return false;
+
+    const uint8_t* table = tables[m.code()];
+    if (!table)
+        return false;
+
+    out = decode(table[tb::index(m, q)]);
+    return true;
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Bitboard.hpp"
+#include "MappedFile.hpp"
+
+// Bazy końcówek z analizy wstecznej (generuje je tools/TbGen.cpp).
+// Każdy układ materiału ma osobny plik z jednym bajtem na pozycję z białymi na ruchu;
+// pozycję z czarnymi na ruchu czyta się po obróceniu planszy o 180° i zamianie kolorów.
+//
+// Bajt: 0 = remis, inaczej 1 + liczba półruchów do końca partii (nieparzysta = wygrywa strona na ruchu).
+namespace tb {
+    constexpr int MAX_PIECES = 8;   // najwięcej figur w jednej tablicy
+    constexpr int MAX_DISTANCE = 253; // dłuższe wygrane generator zapisuje jako remis
+    constexpr size_t HEADER_SIZE = 16; // "WTB1", 4 bajty materiału, liczba pozycji (u64)
+
+    struct Material {
+        int whiteMen = 0, whiteKings = 0, blackMen = 0, blackKings = 0;
+
+        int total() const { return whiteMen + whiteKings + blackMen + blackKings; }
+        Material flipped() const { return { blackMen, blackKings, whiteMen, whiteKings }; }
+        int code() const { return ((whiteMen * 9 + whiteKings) * 9 + blackMen) * 9 + blackKings; }
+        std::string fileName() const; // np. "tb_1021.bin"
+
+        bool operator==(const Material& o) const { return code() == o.code(); }
+        bool operator!=(const Material& o) const { return code() != o.code(); }
+    };
+
+    constexpr int MATERIAL_CODES = 9 * 9 * 9 * 9;
+
+    Material materialOf(const Position& p);
+    Position flip(const Position& p); // obrót o 180° (pole sq -> 31 - sq) i zamiana kolorów
+
+    // Indeks: kombinacje pionów białych (pola 4-31), czarnych (0-27), potem damek na wolnych polach.
+    // Piony obu stron liczone są niezależnie, więc część indeksów to pozycje niemożliwe.
+    uint64_t tableSize(const Material& m);
+    uint64_t index(const Material& m, const Position& p);         // białe na ruchu, materiał p == m
+    bool unindex(const Material& m, uint64_t index, Position& p); // false = pozycja niemożliwa
+}
+
+class Tablebase {
+public:
+    enum class Result : uint8_t { Draw, Win, Loss }; // dla strony na ruchu
+
+    struct Entry {
+        Result result = Result::Draw;
+        int distance = 0; // półruchy do końca partii
+    };
+
+    static Entry decode(uint8_t value);
+
+    int load(const std::string& dir); // wszystkie tb_*.bin z katalogu; zwraca liczbę tablic
+    bool add(const std::string& path);
+    int maxPieces() const { return pieces; } // 0 = brak tablic
+
+    // false, jeśli dla tego materiału nie ma tablicy (albo któraś strona nie ma figur)
+    bool probe(const Position& p, bool whiteTurn, Entry& out) const;
+
+private:
+    std::vector<MappedFile> files;
+    std::vector<const uint8_t*> tables = std::vector<const uint8_t*>(tb::MATERIAL_CODES, nullptr);
+    int pieces = 0;
+};
@@ -0,0 +1,82 @@
+﻿#include "TranspositionTable.hpp"
+
+// Układ słowa data: wynik (32 bity) | głębokość + 1 (8, 0 = pusty) | granica (8) | skąd (8) | dokąd (8)
+uint64_t TranspositionTable::pack(int depth, int score, Bound bound, int from, int to) {
+    return uint64_t(uint32_t(score))
+        | uint64_t(uint8_t(depth + 1)) << 32
+        | uint64_t(bound) << 40
+        | uint64_t(uint8_t(from)) << 48
+        | uint64_t(uint8_t(to)) << 56;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t key, uint64_t data) {
+    TTEntry e;
+    e.key = key;
+    e.score = int32_t(uint32_t(data));
+    e.depth = int8_t(int((data >> 32) & 0xFF) - 1);
+    e.bound = Bound((data >> 40) & 0xFF);
+    e.from = uint8_t(data >> 48);
+    e.to = uint8_t(data >> 56);
+    return e;
+}
+
+void TranspositionTable::resize(size_t sizeMB) {
+    size_t wanted = sizeMB * 1024 * 1024 / sizeof(Slot);
+    size_t pow2 = 1;
+    while (pow2 * 2 <= wanted) pow2 *= 2;
+
+    if (wanted == 0) {
+        slots.reset();
+        count = 0;
+        mask = 0;
+    }
+    else {
+        slots.reset(new Slot[pow2]);
+        count = pow2;
+        mask = pow2 - 1;
+    }
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < count; ++i) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& out) const {
+    if (count == 0) return false;
+
+    const Slot& s = slots[key & mask];
+    uint64_t data = s.data.load(std::memory_order_relaxed);
+    uint64_t check = s.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || (data >> 32 & 0xFF) == 0) return false;
+
+    out = unpack(key, data);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound, int from, int to) {
+    if (count == 0) return;
+
+    Slot& s = slots[key & mask];
+    uint64_t oldData = s.data.load(std::memory_order_relaxed);
+    bool sameKey = (s.check.load(std::memory_order_relaxed) ^ oldData) == key;
+
+    if (sameKey) {
+        TTEntry old = unpack(key, oldData);
+
+        // Ta sama pozycja z głębszego przeszukania jest cenniejsza - nie nadpisuj jej
+        if (old.depth > depth) return;
+
+        // Zachowaj stary najlepszy ruch, jeśli nowy wynik go nie ma (np. odcięcie bez ruchu)
+        if (from == TTEntry::NO_SQUARE) {
+            from = old.from;
+            to = old.to;
+        }
+    }
+
+    uint64_t data = pack(depth, score, bound, from, to);
+    s.data.store(data, std::memory_order_relaxed);
+    s.check.store(key ^ data, std::memory_order_relaxed);
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+enum class Bound : uint8_t { Exact, Lower, Upper };
+
+struct TTEntry {
+    uint64_t key = 0;
+    int32_t score = 0;
+    int8_t depth = -1;       // -1 = pusty wpis
+    Bound bound = Bound::Exact;
+    uint8_t from = NO_SQUARE; // najlepszy ruch (indeksy pól bitboardu)
+    uint8_t to = NO_SQUARE;
+
+    static constexpr uint8_t NO_SQUARE = 0xFF;
+};
+
+// Tablica transpozycji o stałym rozmiarze (potęga dwójki), jeden wpis na indeks.
+// Współdzielona przez wątki przeszukiwania bez blokad: wpis to dwa słowa 64-bitowe,
+// klucz zapisany jako key ^ data, więc rozerwany zapis innego wątku wygląda jak chybienie.
+class TranspositionTable {
+public:
+    TranspositionTable() = default;
+    explicit TranspositionTable(size_t sizeMB) { resize(sizeMB); }
+
+    // resize i clear tylko wtedy, gdy nikt nie szuka
+    void resize(size_t sizeMB);
+    void clear();
+
+    // false, jeśli pod kluczem nic nie ma (albo tablica ma rozmiar 0)
+    bool probe(uint64_t key, TTEntry& out) const;
+    void store(uint64_t key, int depth, int score, Bound bound, int from, int to);
+
+    size_t sizeMB() const { return count * sizeof(Slot) / (1024 * 1024); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{ 0 }; // key ^ data
+        std::atomic<uint64_t> data{ 0 };
+    };
+
+    static uint64_t pack(int depth, int score, Bound bound, int from, int to);
+    static TTEntry unpack(uint64_t key, uint64_t data);
+
+    std::unique_ptr<Slot[]> slots;
+    size_t count = 0;
+    size_t mask = 0;
+};
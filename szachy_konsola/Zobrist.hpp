@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <cstdint>
+#include "Bitboard.hpp"
+
+// Losowe klucze Zobrista; generowane w czasie kompilacji, więc są takie same przy każdym uruchomieniu.
+struct ZobristKeys {
+    uint64_t piece[4][bb::SQUARES]; // [biały pion, biała damka, czarny pion, czarna damka][pole]
+    uint64_t blackToMove;
+};
+
+namespace zobrist {
+
+    constexpr uint64_t splitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    constexpr ZobristKeys makeKeys() {
+        ZobristKeys keys{};
+        uint64_t state = 0x5741524341425931ull;
+        for (int p = 0; p < 4; ++p)
+            for (int sq = 0; sq < bb::SQUARES; ++sq)
+                keys.piece[p][sq] = splitMix64(state);
+        keys.blackToMove = splitMix64(state);
+        return keys;
+    }
+
+    inline constexpr ZobristKeys KEYS = makeKeys();
+
+    inline uint64_t pieceKey(int sq, bool white, bool king) {
+        return KEYS.piece[(white ? 0 : 2) + (king ? 1 : 0)][sq];
+    }
+
+    // Klucz samych figur liczony od zera (do sprawdzania wersji przyrostowej)
+    inline uint64_t compute(const Position& pos) {
+        uint64_t key = 0;
+        Bitboard pieces = pos.occupied();
+        while (pieces) {
+            int sq = bb::popLsb(pieces);
+            key ^= pieceKey(sq, (pos.white & bb::bit(sq)) != 0, (pos.kings & bb::bit(sq)) != 0);
+        }
+        return key;
+    }
+}
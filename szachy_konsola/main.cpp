@@ -2,6 +2,9 @@
 #include <SFML/Window.hpp>
 #include "Board.hpp"
 #include "GameSettings.hpp"
+#include <algorithm>
+#include <thread>
+#include <stdexcept>
 
 
 void drawOption(sf::RenderWindow& window, const sf::Font& font, const std::string& label, int x, int y, bool selected) {
@@ -13,6 +16,20 @@ void drawOption(sf::RenderWindow& window, const sf::Font& font, const std::strin
     window.draw(text);
 }
 
+std::string timeLabel(int ms) {
+    if (ms <= 0) return "off";
+    if (ms % 1000 == 0) return std::to_string(ms / 1000) + " s";
+    return std::to_string(ms) + " ms";
+}
+
+std::string bookLabel(BookMode mode) {
+    switch (mode) {
+    case BookMode::Best: return "best";
+    case BookMode::Random: return "random";
+    default: return "off";
+    }
+}
+
 
 
 
@@ -24,7 +41,6 @@ GameSettings showMenu(sf::RenderWindow& window) {
 
     int selectedOption = 0;
     GameSettings settings;
-    bool wasPressed = false;
 
     std::vector<std::string> options = {
         "Human vs Human",
@@ -32,68 +48,138 @@ GameSettings showMenu(sf::RenderWindow& window) {
         "AI (W) vs Human (B)",
         "AI vs AI",
         "White Depth: 3",
-        "Black Depth: 3"
+        "Black Depth: 3",
+        "White Time: off",
+        "Black Time: off",
+        "Clock: off",
+        "Increment: off",
+        "Threads: " + std::to_string(settings.searchThreads),
+        "Book: " + bookLabel(settings.bookMode),
+        "Ponder: on"
     };
 
+    const int MOVE_TIME_STEP = 250;      // ms
+    const int CLOCK_STEP = 60 * 1000;    // ms
+    const int INCREMENT_STEP = 1000;     // ms
+    const int MAX_THREADS = std::max(1, int(std::thread::hardware_concurrency()));
+
+    auto redraw = [&]() {
+        window.clear();
+        for (int i = 0; i < int(options.size()); ++i) {
+            drawOption(window, font, options[i], 100, 45 + i * 45, selectedOption == i);
+        }
+        window.display();
+    };
+    redraw();
+
+    // Menu zmienia się tylko po naciśnięciu klawisza, więc pętla śpi w waitEvent zamiast rysować co klatkę
     while (window.isOpen()) {
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up)) {
-            if (!wasPressed) {
-                selectedOption = (selectedOption - 1 + options.size()) % options.size();
-                wasPressed = true;
-            }
+        const std::optional event = window.waitEvent();
+        if (!event) continue;
+        if (event->is<sf::Event::Closed>()) {
+            window.close();
+            break;
         }
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down)) {
-            if (!wasPressed) {
-                selectedOption = (selectedOption + 1) % options.size();
-                wasPressed = true;
-            }
+
+        const auto* key = event->getIf<sf::Event::KeyPressed>();
+        if (!key) {
+            if (event->is<sf::Event::FocusGained>() || event->is<sf::Event::Resized>())
+                redraw(); // zawartość okna mogła przepaść
+            continue;
         }
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left)) {
-            if (!wasPressed) {
-                if (selectedOption == 4 && settings.whiteDepth > 1) {
-                    --settings.whiteDepth;
-                    options[4] = "White Depth: " + std::to_string(settings.whiteDepth);
-                }
-                else if (selectedOption == 5 && settings.blackDepth > 1) {
-                    --settings.blackDepth;
-                    options[5] = "Black Depth: " + std::to_string(settings.blackDepth);
-                }
-                wasPressed = true;
-            }
+
+        if (key->code == sf::Keyboard::Key::Up) {
+            selectedOption = (selectedOption - 1 + options.size()) % options.size();
+        }
+        else if (key->code == sf::Keyboard::Key::Down) {
+            selectedOption = (selectedOption + 1) % options.size();
         }
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right)) {
-            if (!wasPressed) {
-                if (selectedOption == 4) {
-                    ++settings.whiteDepth;
-                    options[4] = "White Depth: " + std::to_string(settings.whiteDepth);
-                }
-                else if (selectedOption == 5) {
-                    ++settings.blackDepth;
-                    options[5] = "Black Depth: " + std::to_string(settings.blackDepth);
-                }
-                wasPressed = true;
+        else if (key->code == sf::Keyboard::Key::Left) {
+            if (selectedOption == 4 && settings.whiteDepth > 1) {
+                --settings.whiteDepth;
+                options[4] = "White Depth: " + std::to_string(settings.whiteDepth);
+            }
+            else if (selectedOption == 5 && settings.blackDepth > 1) {
+                --settings.blackDepth;
+                options[5] = "Black Depth: " + std::to_string(settings.blackDepth);
+            }
+            else if (selectedOption == 6 && settings.whiteMoveTimeMs > 0) {
+                settings.whiteMoveTimeMs -= MOVE_TIME_STEP;
+                options[6] = "White Time: " + timeLabel(settings.whiteMoveTimeMs);
+            }
+            else if (selectedOption == 7 && settings.blackMoveTimeMs > 0) {
+                settings.blackMoveTimeMs -= MOVE_TIME_STEP;
+                options[7] = "Black Time: " + timeLabel(settings.blackMoveTimeMs);
+            }
+            else if (selectedOption == 8 && settings.clockMs > 0) {
+                settings.clockMs -= CLOCK_STEP;
+                options[8] = "Clock: " + timeLabel(settings.clockMs);
+            }
+            else if (selectedOption == 9 && settings.incrementMs > 0) {
+                settings.incrementMs -= INCREMENT_STEP;
+                options[9] = "Increment: " + timeLabel(settings.incrementMs);
+            }
+            else if (selectedOption == 10 && settings.searchThreads > 1) {
+                --settings.searchThreads;
+                options[10] = "Threads: " + std::to_string(settings.searchThreads);
+            }
+            else if (selectedOption == 11 && settings.bookMode != BookMode::Off) {
+                settings.bookMode = BookMode(int(settings.bookMode) - 1);
+                options[11] = "Book: " + bookLabel(settings.bookMode);
+            }
+            else if (selectedOption == 12) {
+                settings.ponder = !settings.ponder;
+                options[12] = settings.ponder ? "Ponder: on" : "Ponder: off";
             }
         }
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter)) {
-            if (!wasPressed) {
-                switch (selectedOption) {
-                case 0: settings.whitePlayer = PlayerType::Human; settings.blackPlayer = PlayerType::Human; return settings;
-                case 1: settings.whitePlayer = PlayerType::Human; settings.blackPlayer = PlayerType::AI; return settings;
-                case 2: settings.whitePlayer = PlayerType::AI; settings.blackPlayer = PlayerType::Human; return settings;
-                case 3: settings.whitePlayer = PlayerType::AI; settings.blackPlayer = PlayerType::AI; return settings;
-                }
-                wasPressed = true;
+        else if (key->code == sf::Keyboard::Key::Right) {
+            if (selectedOption == 4) {
+                ++settings.whiteDepth;
+                options[4] = "White Depth: " + std::to_string(settings.whiteDepth);
+            }
+            else if (selectedOption == 5) {
+                ++settings.blackDepth;
+                options[5] = "Black Depth: " + std::to_string(settings.blackDepth);
+            }
+            else if (selectedOption == 6) {
+                settings.whiteMoveTimeMs += MOVE_TIME_STEP;
+                options[6] = "White Time: " + timeLabel(settings.whiteMoveTimeMs);
+            }
+            else if (selectedOption == 7) {
+                settings.blackMoveTimeMs += MOVE_TIME_STEP;
+                options[7] = "Black Time: " + timeLabel(settings.blackMoveTimeMs);
+            }
+            else if (selectedOption == 8) {
+                settings.clockMs += CLOCK_STEP;
+                options[8] = "Clock: " + timeLabel(settings.clockMs);
+            }
+            else if (selectedOption == 9) {
+                settings.incrementMs += INCREMENT_STEP;
+                options[9] = "Increment: " + timeLabel(settings.incrementMs);
+            }
+            else if (selectedOption == 10 && settings.searchThreads < MAX_THREADS) {
+                ++settings.searchThreads;
+                options[10] = "Threads: " + std::to_string(settings.searchThreads);
+            }
+            else if (selectedOption == 11 && settings.bookMode != BookMode::Random) {
+                settings.bookMode = BookMode(int(settings.bookMode) + 1);
+                options[11] = "Book: " + bookLabel(settings.bookMode);
+            }
+            else if (selectedOption == 12) {
+                settings.ponder = !settings.ponder;
+                options[12] = settings.ponder ? "Ponder: on" : "Ponder: off";
             }
         }
-        else {
-            wasPressed = false;
+        else if (key->code == sf::Keyboard::Key::Enter) {
+            switch (selectedOption) {
+            case 0: settings.whitePlayer = PlayerType::Human; settings.blackPlayer = PlayerType::Human; return settings;
+            case 1: settings.whitePlayer = PlayerType::Human; settings.blackPlayer = PlayerType::AI; return settings;
+            case 2: settings.whitePlayer = PlayerType::AI; settings.blackPlayer = PlayerType::Human; return settings;
+            case 3: settings.whitePlayer = PlayerType::AI; settings.blackPlayer = PlayerType::AI; return settings;
+            }
         }
 
-        window.clear();
-        for (int i = 0; i < options.size(); ++i) {
-            drawOption(window, font, options[i], 100, 100 + i * 50, selectedOption == i);
-        }
-        window.display();
+        redraw();
     }
 
     return settings;
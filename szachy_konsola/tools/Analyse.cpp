@@ -0,0 +1,239 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <climits>
+#include <algorithm>
+#include "../Search.hpp"
+#include "../Notation.hpp"
+#include "../Pdn.hpp"
+
+// Analiza archiwum partii PDN: każda pozycja każdej partii liczona na stałą głębokość albo liczbę węzłów,
+// a po każdym ruchu komentarz z najlepszym ruchem silnika i oceną, np. {best 24-20 +35/10}
+// (ocena z punktu widzenia białych, pion = GameState::PAWN_VALUE = 100; +win / -win = wygrana białych / czarnych wyliczona do końca).
+//
+// Czytanie, liczenie i zapis idą potokiem: wątek główny czyta partie strumieniowo, wątki robocze liczą
+// po jednej partii (każdy ma własny Search), a wątek zapisu oddaje je w kolejności z pliku. W drodze jest
+// najwyżej WINDOW_PER_THREAD partii na wątek, więc pamięć nie rośnie z rozmiarem pliku.
+// TT jest czyszczona przed każdą partią, więc wynik nie zależy od liczby wątków.
+//
+// analyse [--depth N | --nodes N] [--threads N] [--hash MB] [--tablebases KATALOG] [--out PLIK] WEJŚCIE.pdn
+
+namespace {
+    constexpr int WINDOW_PER_THREAD = 4;
+
+    struct Options {
+        int depth = 8;
+        uint64_t nodes = 0; // > 0 zamiast głębokości
+        int threads = std::max(1, int(std::thread::hardware_concurrency()));
+        int hashMB = 4; // TT jest czyszczona przed każdą partią - przy płytkiej analizie duża kosztuje więcej niż liczenie
+        std::string tablebases;
+        std::string out = "analysed.pdn";
+        std::string in;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& o) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) {
+                if (!o.in.empty()) return false;
+                o.in = arg;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            try {
+                if (arg == "--depth") o.depth = std::clamp(std::stoi(value), 1, MAX_SEARCH_DEPTH);
+                else if (arg == "--nodes") o.nodes = std::stoull(value);
+                else if (arg == "--threads") o.threads = std::max(1, std::stoi(value));
+                else if (arg == "--hash") o.hashMB = std::max(0, std::stoi(value));
+                else if (arg == "--tablebases") o.tablebases = value;
+                else if (arg == "--out") o.out = value;
+                else return false;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        }
+        return !o.in.empty();
+    }
+
+    std::string scoreText(int score) {
+        if (score == INT_MAX - 1 || score >= TB_WIN_SCORE - tb::MAX_DISTANCE - 1) return "+win";
+        if (score == INT_MIN + 1 || score <= -(TB_WIN_SCORE - tb::MAX_DISTANCE - 1)) return "-win";
+        return (score > 0 ? "+" : "") + std::to_string(score);
+    }
+
+    struct Job {
+        size_t index = 0;
+        pdn::Game game;
+        int positions = 0;
+    };
+
+    // Komentarz po każdym ruchu; na nielegalnym ruchu analiza partii się kończy, a partia idzie dalej bez zmian
+    int analyseGame(Search& search, const Options& o, pdn::Game& game) {
+        GameState state;
+        bool whiteTurn = true;
+        std::string fen = game.tag("FEN");
+        if (!notation::parseFen(fen.empty() ? notation::startFen() : fen, state, whiteTurn)) {
+            game.preface += (game.preface.empty() ? "" : " ") + std::string("analysis: bad FEN");
+            return 0;
+        }
+
+        search.clearTT();
+        int positions = 0;
+        for (size_t i = 0; i < game.moves.size(); ++i) {
+            Move played = notation::parseMove(state, whiteTurn, game.moves[i]);
+            if (played.isNull()) {
+                game.comments[i] += (game.comments[i].empty() ? "" : " ") + std::string("analysis: illegal move");
+                break;
+            }
+
+            SearchResult r = search.run(state, whiteTurn, o.nodes > 0 ? MAX_SEARCH_DEPTH : o.depth, 0, o.nodes);
+            ++positions;
+            if (r.depth > 0) { // jedyny legalny ruch nie jest liczony, więc nie ma czego komentować
+                std::string note = "best " + notation::moveToString(state, whiteTurn, r.move) + " "
+                    + scoreText(r.score) + "/" + std::to_string(r.depth);
+                game.comments[i] += (game.comments[i].empty() ? "" : " ") + note;
+            }
+
+            state.applyMove(played, whiteTurn);
+            whiteTurn = !whiteTurn;
+        }
+        return positions;
+    }
+}
+
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        std::cerr << "usage: analyse [--depth N | --nodes N] [--threads N] [--hash MB] [--tablebases DIR] [--out FILE] INPUT.pdn\n";
+        return 1;
+    }
+
+    std::ifstream in(o.in);
+    if (!in) {
+        std::cerr << "cannot read " << o.in << "\n";
+        return 1;
+    }
+    std::ofstream out(o.out);
+    if (!out) {
+        std::cerr << "cannot write " << o.out << "\n";
+        return 1;
+    }
+
+    Tablebase tablebase;
+    if (!o.tablebases.empty())
+        tablebase.load(o.tablebases);
+
+    const size_t window = size_t(o.threads) * WINDOW_PER_THREAD;
+    std::mutex mutex;
+    std::condition_variable workReady, resultReady, spaceFree;
+    std::deque<Job> work;
+    std::map<size_t, Job> done; // policzone partie czekające na zapis w kolejności
+    size_t read = 0, written = 0;
+    uint64_t positions = 0;
+    bool endOfInput = false;
+
+    std::cout << "Analysing " << o.in << " ("
+        << (o.nodes > 0 ? std::to_string(o.nodes) + " nodes" : "depth " + std::to_string(o.depth))
+        << " per position, " << o.threads << " threads) into " << o.out << "\n";
+    Clock::time_point start = Clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < o.threads; ++t) {
+        workers.emplace_back([&] {
+            Search search;
+            search.resizeTT(size_t(o.hashMB));
+            search.setTablebase(tablebase.maxPieces() > 0 ? &tablebase : nullptr);
+
+            for (;;) {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    workReady.wait(lock, [&] { return !work.empty() || endOfInput; });
+                    if (work.empty()) return;
+                    job = std::move(work.front());
+                    work.pop_front();
+                }
+
+                job.positions = analyseGame(search, o, job.game);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                done.emplace(job.index, std::move(job));
+                resultReady.notify_one();
+            }
+        });
+    }
+
+    std::thread writer([&] {
+        Clock::time_point lastReport = Clock::now();
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                resultReady.wait(lock, [&] { return done.count(written) || (endOfInput && written == read); });
+                auto it = done.find(written);
+                if (it == done.end()) return;
+                job = std::move(it->second);
+                done.erase(it);
+            }
+
+            pdn::write(out, job.game);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ++written;
+            positions += job.positions;
+            spaceFree.notify_one();
+
+            if (Clock::now() - lastReport > std::chrono::seconds(5)) {
+                lastReport = Clock::now();
+                double seconds = std::chrono::duration<double>(lastReport - start).count();
+                std::cout << written << " games, " << positions << " positions, " << std::fixed << std::setprecision(1)
+                    << written / seconds << " games/s" << std::defaultfloat << std::endl;
+            }
+        }
+    });
+
+    pdn::Reader reader(in);
+    pdn::Game game;
+    while (reader.next(game)) {
+        game.setTag("Annotator", o.nodes > 0 ? "Warcaby " + std::to_string(o.nodes) + " nodes"
+                                             : "Warcaby depth " + std::to_string(o.depth));
+
+        std::unique_lock<std::mutex> lock(mutex);
+        spaceFree.wait(lock, [&] { return read - written < window; });
+        work.push_back({ read++, std::move(game), 0 });
+        workReady.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        endOfInput = true;
+    }
+    workReady.notify_all();
+    resultReady.notify_all();
+
+    for (std::thread& w : workers)
+        w.join();
+    writer.join();
+    out.close();
+    if (!out) {
+        std::cerr << "error writing " << o.out << "\n";
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "analysed " << written << " games, " << positions << " positions in " << std::fixed << std::setprecision(1)
+        << seconds << " s: " << written / std::max(seconds, 1e-9) << " games/s, "
+        << std::setprecision(0) << positions / std::max(seconds, 1e-9) << " positions/s\n";
+    return 0;
+}
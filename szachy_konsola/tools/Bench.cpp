@@ -0,0 +1,296 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include <iterator>
+#include "../Search.hpp"
+#include "Positions.hpp"
+
+// Benchmark przeszukiwania wielowątkowego: czas do osiągnięcia głębokości na stałych pozycjach,
+// jeden wątek kontra N wątków (Lazy SMP). Przed każdym pomiarem TT jest czyszczona.
+// BF = średnio przeszukanych ruchów na węzeł, cut1 = odsetek odcięć na pierwszym ruchu (pomiar jednowątkowy).
+//
+// bench [wątki] [min głębokość] [max głębokość] [TT w MB]
+//
+// bench features [głębokość] [TT w MB] - jeden wątek, suma węzłów i czasu na wszystkich pozycjach
+// z włączonymi po kolei przełącznikami przeszukiwania (PVS, okna aspiracyjne, LMR) względem czystego alpha-beta.
+//
+// bench primitives - koszt jednego wywołania generatora ruchów i sprawdzeń bicia (ns), najlepszy z kilku pomiarów,
+// na zestawie corpusPositions() z tools/Positions.hpp: 2566 pozycji, z tego 26 stałych (4 pozycje testowe
+// i 11 scenariuszy z obu stron) i 2540 z 40 losowych partii o stałym ziarnie. "targets scan" to dawne
+// podpowiedzi ruchów z Board (8 kandydatów dx/dy, isInside, pole środkowe) - porównanie z GameState::targetsFrom.
+
+struct Measurement {
+    double ms = 0;
+    uint64_t nodes = 0;
+    int score = 0;
+    double branching = 0;
+    double firstCutoff = 0;
+};
+
+static Measurement measure(Search& search, const GameState& state, bool whiteTurn, int depth) {
+    using Clock = std::chrono::steady_clock;
+
+    search.clearTT();
+    Clock::time_point start = Clock::now();
+    SearchResult result = search.run(state, whiteTurn, depth, 0);
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+    return { elapsed.count(), result.nodes, result.score, result.branchingFactor(), result.firstMoveCutoffRate() };
+}
+
+struct FeatureSet {
+    const char* name;
+    bool pvs, aspiration, lmr;
+};
+
+static int runFeatures(int argc, char** argv) {
+    int depth = 10;
+    int ttSizeMB = 64;
+    if (argc > 2) depth = std::max(1, std::stoi(argv[2]));
+    if (argc > 3) ttSizeMB = std::max(0, std::stoi(argv[3]));
+
+    const FeatureSet sets[] = {
+        { "alpha-beta", false, false, false },
+        { "+pvs", true, false, false },
+        { "+aspiration", false, true, false },
+        { "+lmr", false, false, true },
+        { "all", true, true, true },
+    };
+
+    Search search;
+    search.resizeTT(ttSizeMB);
+    search.setThreads(1);
+
+    std::cout << "Search features at depth " << depth << ", 1 thread, TT " << ttSizeMB << " MB\n\n";
+    std::cout << std::left << std::setw(14) << "features" << std::right << std::setw(14) << "nodes"
+        << std::setw(10) << "vs a-b" << std::setw(12) << "ms" << std::setw(7) << "BF" << "  scores\n";
+
+    uint64_t baseline = 0;
+    std::cout << std::fixed;
+    for (const FeatureSet& set : sets) {
+        search.setPvs(set.pvs);
+        search.setAspiration(set.aspiration);
+        search.setLateMoveReductions(set.lmr);
+
+        uint64_t nodes = 0;
+        double ms = 0, branching = 0;
+        std::string scores;
+        for (const TestPosition& tp : testPositions()) {
+            GameState state;
+            if (!setupPosition(state, tp.rows)) {
+                std::cerr << "Bad position: " << tp.name << "\n";
+                return 1;
+            }
+            Measurement m = measure(search, state, tp.whiteTurn, depth);
+            nodes += m.nodes;
+            ms += m.ms;
+            branching += m.branching / testPositions().size();
+            scores += " " + std::to_string(m.score);
+        }
+        if (!baseline) baseline = nodes;
+
+        std::cout << std::left << std::setw(14) << set.name << std::right << std::setw(14) << nodes
+            << std::setprecision(1) << std::setw(9) << 100.0 * nodes / baseline << "%"
+            << std::setw(12) << ms << std::setprecision(2) << std::setw(7) << branching << " " << scores << "\n";
+    }
+    return 0;
+}
+
+// Dawne Board::updatePossibleMoves + isValidMove na GameState, tylko do porównania z targetsFrom
+static Bitboard scanTargets(const GameState& state, int row, int col, bool whiteTurn, bool inCombo) {
+    auto inside = [](int x, int y) { return x >= 0 && x < 8 && y >= 0 && y < 8; };
+    auto at = [&](int x, int y) { // 0 puste, 1 białe, 2 czarne; +2 damka
+        int sq = bb::square(x, y);
+        if (sq < 0 || !(state.pos.occupied() & bb::bit(sq))) return 0;
+        return ((state.pos.white & bb::bit(sq)) ? 1 : 2) + ((state.pos.kings & bb::bit(sq)) ? 2 : 0);
+    };
+
+    int p = at(row, col);
+    bool king = p > 2, white = p == 1 || p == 3;
+    bool capturePossible = state.hasCapture(whiteTurn);
+    const int dxs[] = { -2, -2, 2, 2, -1, -1, 1, 1 };
+    const int dys[] = { -2, 2, -2, 2, -1, 1, -1, 1 };
+
+    Bitboard targets = 0;
+    for (int i = 0; i < 8; ++i) {
+        int x2 = row + dxs[i], y2 = col + dys[i];
+        if (!inside(x2, y2) || at(x2, y2) != 0) continue;
+        int dx = dxs[i];
+        if (std::abs(dx) == 1) {
+            if (inCombo || capturePossible) continue;
+            if (king || (white && dx == -1) || (!white && dx == 1))
+                targets |= bb::bit(bb::square(x2, y2));
+        }
+        else {
+            int mid = at(row + dx / 2, col + dys[i] / 2);
+            bool enemy = mid != 0 && ((mid == 1 || mid == 3) != whiteTurn);
+            if (enemy && (king || (white && dx == -2) || (!white && dx == 2)))
+                targets |= bb::bit(bb::square(x2, y2));
+        }
+    }
+    return targets;
+}
+
+// Najlepszy z ROUNDS przebiegów po wszystkich pozycjach; fn zwraca liczbę wywołań i coś do sumy kontrolnej
+template <typename Fn>
+static double nsPerCall(const std::vector<CorpusPosition>& samples, Fn fn) {
+    using Clock = std::chrono::steady_clock;
+    constexpr int ROUNDS = 7, REPEAT = 50;
+
+    double best = 1e300;
+    volatile uint64_t sink = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        uint64_t calls = 0, sum = 0;
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < REPEAT; ++r)
+            for (const CorpusPosition& s : samples)
+                calls += fn(s, sum);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        sink = sink + sum;
+        best = std::min(best, ns / std::max<uint64_t>(calls, 1));
+    }
+    return best;
+}
+
+static int runPrimitives() {
+    std::vector<CorpusPosition> samples = corpusPositions(), captures;
+    std::copy_if(samples.begin(), samples.end(), std::back_inserter(captures), [](const CorpusPosition& s) { return s.state.hasCapture(s.whiteTurn); });
+    std::cout << "Primitives on " << samples.size() << " positions (" << captures.size() << " with a capture), ns per call (best of 7)\n\n"
+        << std::fixed << std::setprecision(1);
+
+    auto report = [](const char* name, double ns) { std::cout << std::left << std::setw(22) << name << std::right << std::setw(10) << ns << "\n"; };
+    auto generate = [](const CorpusPosition& s, uint64_t& sum) {
+        MoveList moves;
+        s.state.generateMoves(s.whiteTurn, moves);
+        sum += moves.size();
+        return 1;
+    };
+
+    report("generateMoves", nsPerCall(samples, generate));
+    report("generateMoves capture", nsPerCall(captures, generate));
+    report("hasCapture", nsPerCall(samples, [](const CorpusPosition& s, uint64_t& sum) {
+        sum += s.state.hasCapture(s.whiteTurn);
+        return 1;
+    }));
+    report("canCaptureFrom", nsPerCall(samples, [](const CorpusPosition& s, uint64_t& sum) {
+        Bitboard own = s.state.pos.pieces(s.whiteTurn);
+        int calls = 0;
+        while (own) {
+            sum += s.state.canCaptureFrom(bb::popLsb(own), s.whiteTurn);
+            ++calls;
+        }
+        return calls;
+    }));
+    report("canBeCaptured", nsPerCall(samples, [](const CorpusPosition& s, uint64_t& sum) {
+        Bitboard all = s.state.pos.occupied();
+        int calls = 0;
+        while (all) {
+            int sq = bb::popLsb(all);
+            sum += s.state.canBeCaptured(bb::row(sq), bb::col(sq), (s.state.pos.white & bb::bit(sq)) != 0);
+            ++calls;
+        }
+        return calls;
+    }));
+    int differ = 0;
+    for (const CorpusPosition& s : samples) {
+        Bitboard own = s.state.pos.pieces(s.whiteTurn);
+        while (own) {
+            int sq = bb::popLsb(own);
+            for (bool inCombo : { false, true })
+                differ += scanTargets(s.state, bb::row(sq), bb::col(sq), s.whiteTurn, inCombo) != s.state.targetsFrom(sq, s.whiteTurn, inCombo);
+        }
+    }
+    if (differ) {
+        std::cerr << "targetsFrom differs from the scan on " << differ << " pieces\n";
+        return 1;
+    }
+
+    auto eachPiece = [](auto targets) {
+        return [targets](const CorpusPosition& s, uint64_t& sum) {
+            Bitboard own = s.state.pos.pieces(s.whiteTurn);
+            int calls = 0;
+            while (own) {
+                sum += targets(s.state, bb::popLsb(own), s.whiteTurn);
+                ++calls;
+            }
+            return calls;
+        };
+    };
+    report("targets scan", nsPerCall(samples, eachPiece([](const GameState& state, int sq, bool whiteTurn) {
+        return scanTargets(state, bb::row(sq), bb::col(sq), whiteTurn, false);
+    })));
+    report("targetsFrom", nsPerCall(samples, eachPiece([](const GameState& state, int sq, bool whiteTurn) {
+        return state.targetsFrom(sq, whiteTurn, false);
+    })));
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "features")
+        return runFeatures(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "primitives")
+        return runPrimitives();
+
+    int threads = std::max(1, int(std::thread::hardware_concurrency()));
+    int minDepth = 8;
+    int maxDepth = 12;
+    int ttSizeMB = 64;
+
+    if (argc > 1) threads = std::max(1, std::stoi(argv[1]));
+    if (argc > 2) minDepth = std::max(1, std::stoi(argv[2]));
+    if (argc > 3) maxDepth = std::max(minDepth, std::stoi(argv[3]));
+    if (argc > 4) ttSizeMB = std::max(0, std::stoi(argv[4]));
+
+    Search single, parallel;
+    single.resizeTT(ttSizeMB);
+    parallel.resizeTT(ttSizeMB);
+    single.setThreads(1);
+    parallel.setThreads(threads);
+
+    std::cout << "Lazy SMP: 1 vs " << threads << " threads, TT " << ttSizeMB << " MB\n\n";
+    std::cout << std::left << std::setw(7) << "depth" << std::setw(13) << "position"
+        << std::right << std::setw(12) << "1T ms" << std::setw(12) << "NT ms"
+        << std::setw(10) << "speedup" << std::setw(14) << "1T nodes" << std::setw(14) << "NT nodes"
+        << std::setw(7) << "BF" << std::setw(8) << "cut1" << "\n";
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (int depth = minDepth; depth <= maxDepth; ++depth) {
+        double total1 = 0, totalN = 0;
+
+        for (const TestPosition& tp : testPositions()) {
+            GameState state;
+            if (!setupPosition(state, tp.rows)) {
+                std::cerr << "Bad position: " << tp.name << "\n";
+                return 1;
+            }
+
+            Measurement one = measure(single, state, tp.whiteTurn, depth);
+            Measurement many = measure(parallel, state, tp.whiteTurn, depth);
+            total1 += one.ms;
+            totalN += many.ms;
+
+            std::cout << std::left << std::setw(7) << depth << std::setw(13) << tp.name
+                << std::right << std::setw(12) << one.ms << std::setw(12) << many.ms
+                << std::setw(9) << (many.ms > 0 ? one.ms / many.ms : 0.0) << "x"
+                << std::setw(14) << one.nodes << std::setw(14) << many.nodes
+                << std::setprecision(2) << std::setw(7) << one.branching
+                << std::setprecision(1) << std::setw(7) << 100 * one.firstCutoff << "%";
+
+            // Wątki dzielą się TT, więc wynik może się różnić od jednowątkowego przy odcięciach z TT
+            if (one.score != many.score)
+                std::cout << "  (score " << one.score << " vs " << many.score << ")";
+            std::cout << "\n";
+        }
+
+        std::cout << std::left << std::setw(7) << depth << std::setw(13) << "total"
+            << std::right << std::setw(12) << total1 << std::setw(12) << totalN
+            << std::setw(9) << (totalN > 0 ? total1 / totalN : 0.0) << "x\n\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,196 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <unordered_set>
+#include <filesystem>
+#include "../Search.hpp"
+#include "../Book.hpp"
+#include "../Scenarios.hpp"
+
+// Generator księgi otwarć: od pozycji startowej, poziom po poziomie do N półruchów.
+// Każdy legalny ruch pozycji jest liczony osobnym przeszukaniem na zadaną głębokość; do księgi trafiają
+// ruchy nie gorsze od najlepszego o więcej niż margines (waga maleje z różnicą), i tylko one
+// są rozwijane dalej. Pozycje powtarzające się przez transpozycje liczone są raz.
+// Przeszukania jednego poziomu idą równolegle, każdy wątek ma własny Search.
+//
+// bookgen [--plies N] [--depth N] [--margin CP] [--out PLIK] [--threads N] [--hash MB] [--tablebases KATALOG]
+
+namespace {
+    struct Options {
+        int plies = 8;
+        int depth = 10;
+        int margin = GameState::PAWN_VALUE * 2 / 5; // 0.4 piona w jednostkach oceny
+        std::string out = "book.bin";
+        int threads = std::max(1, int(std::thread::hardware_concurrency()));
+        int hashMB = 16;
+        std::string tablebases;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& o) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            try {
+                if (arg == "--plies") o.plies = std::max(1, std::stoi(value));
+                else if (arg == "--depth") o.depth = std::clamp(std::stoi(value), 1, MAX_SEARCH_DEPTH);
+                else if (arg == "--margin") o.margin = std::clamp(std::stoi(value), 0, 1000);
+                else if (arg == "--out") o.out = value;
+                else if (arg == "--threads") o.threads = std::max(1, std::stoi(value));
+                else if (arg == "--hash") o.hashMB = std::max(0, std::stoi(value));
+                else if (arg == "--tablebases") o.tablebases = value;
+                else return false;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct Node {
+        GameState state;
+        bool whiteTurn = true;
+    };
+
+    // Jedno przeszukanie: ruch z pozycji node, wynik z punktu widzenia strony na ruchu
+    struct Task {
+        int node = 0;
+        Move move;
+        int score = 0;
+    };
+
+    bool writeBook(std::vector<book::Entry>& entries, const std::string& path) {
+        std::stable_sort(entries.begin(), entries.end(), [](const book::Entry& a, const book::Entry& b) {
+            return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+        });
+
+        std::string tmp = path + ".tmp";
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out) return false;
+
+        uint8_t header[book::HEADER_SIZE] = { 'W', 'B', 'K', '1' };
+        for (int i = 0; i < 8; ++i)
+            header[8 + i] = uint8_t(uint64_t(entries.size()) >> (8 * i));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        uint8_t buffer[book::ENTRY_SIZE];
+        for (const book::Entry& e : entries) {
+            book::encode(e, buffer);
+            out.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+        }
+        out.close();
+        if (!out) return false;
+
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        return !ec;
+    }
+}
+
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        std::cerr << "usage: bookgen [--plies N] [--depth N] [--margin CP] [--out FILE] [--threads N] [--hash MB]\n"
+                     "               [--tablebases DIR]\n";
+        return 1;
+    }
+
+    Tablebase tablebase;
+    if (!o.tablebases.empty())
+        tablebase.load(o.tablebases);
+
+    std::vector<std::unique_ptr<Search>> searches;
+    for (int i = 0; i < o.threads; ++i) {
+        searches.push_back(std::make_unique<Search>());
+        searches.back()->resizeTT(size_t(o.hashMB));
+        searches.back()->setTablebase(tablebase.maxPieces() > 0 ? &tablebase : nullptr);
+    }
+
+    std::cout << "Book: " << o.plies << " plies, depth " << o.depth << ", margin " << o.margin
+        << ", " << o.threads << " threads\n";
+    Clock::time_point start = Clock::now();
+
+    std::vector<Node> level(1);
+    scenario::startPosition(level[0].state);
+    std::unordered_set<uint64_t> seen{ level[0].state.key(true) };
+    std::vector<book::Entry> entries;
+
+    for (int ply = 0; ply < o.plies && !level.empty(); ++ply) {
+        Clock::time_point t0 = Clock::now();
+
+        std::vector<Task> tasks;
+        for (int n = 0; n < int(level.size()); ++n) {
+            MoveList moves;
+            level[n].state.generateMoves(level[n].whiteTurn, moves);
+            for (Move m : moves)
+                tasks.push_back({ n, m, 0 });
+        }
+
+        std::atomic<size_t> next{ 0 };
+        std::vector<std::thread> workers;
+        for (int t = 0; t < o.threads; ++t) {
+            workers.emplace_back([&, t] {
+                Search& search = *searches[t];
+                for (size_t i = next++; i < tasks.size(); i = next++) {
+                    Task& task = tasks[i];
+                    const Node& node = level[task.node];
+                    GameState child = node.state;
+                    child.applyMove(task.move, node.whiteTurn);
+                    SearchResult r = search.run(child, !node.whiteTurn, std::max(1, o.depth - 1), 0);
+                    task.score = node.whiteTurn ? r.score : -r.score;
+                }
+            });
+        }
+        for (std::thread& w : workers)
+            w.join();
+
+        // Zadania są pogrupowane po pozycjach, w kolejności generatora
+        std::vector<Node> nextLevel;
+        for (size_t begin = 0; begin < tasks.size();) {
+            size_t end = begin;
+            int best = tasks[begin].score;
+            while (end < tasks.size() && tasks[end].node == tasks[begin].node)
+                best = std::max(best, tasks[end++].score);
+
+            const Node& node = level[tasks[begin].node];
+            uint64_t key = node.state.key(node.whiteTurn);
+            for (size_t i = begin; i < end; ++i) {
+                int gap = best - tasks[i].score;
+                if (gap > o.margin)
+                    continue;
+                entries.push_back({ key, tasks[i].move, o.margin - gap + 1 });
+
+                Node child = node;
+                child.state.applyMove(tasks[i].move, node.whiteTurn);
+                child.whiteTurn = !node.whiteTurn;
+                if (seen.insert(child.state.key(child.whiteTurn)).second)
+                    nextLevel.push_back(child);
+            }
+            begin = end;
+        }
+
+        std::cout << "ply " << ply + 1 << ": " << level.size() << " positions, " << tasks.size() << " searches, "
+            << entries.size() << " entries, " << std::fixed << std::setprecision(2)
+            << std::chrono::duration<double>(Clock::now() - t0).count() << " s\n";
+        level = std::move(nextLevel);
+    }
+
+    if (!writeBook(entries, o.out)) {
+        std::cerr << "cannot write " << o.out << "\n";
+        return 1;
+    }
+    std::cout << "wrote " << entries.size() << " entries to " << o.out << " in " << std::fixed << std::setprecision(1)
+        << std::chrono::duration<double>(Clock::now() - start).count() << " s\n";
+    return 0;
+}
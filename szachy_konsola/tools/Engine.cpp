@@ -0,0 +1,334 @@
+﻿#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <climits>
+#include <algorithm>
+#include "../Search.hpp"
+#include "../Notation.hpp"
+#include "../Stats.hpp"
+
+// Silnik bez okna sterowany tekstowo przez stdin/stdout, w stylu UCI (pozycje i ruchy w zapisie z Notation.hpp).
+//
+//   uci                                   -> id ..., option ..., uciok
+//   isready                               -> readyok
+//   setoption name Hash|Threads value N
+//   setoption name TablebasePath value <katalog>   bazy końcówek z tbgen
+//   setoption name StatsLog value <plik>           dopisuje linię JSON (stats::toJson) po każdym go
+//   ucinewgame                            czyści TT
+//   position startpos|fen <FEN> [moves <ruch> ...]
+//   go [depth N] [movetime MS] [nodes N] [infinite]
+//                                         -> info depth D score cp S|win [N]|loss [N] nodes N nps N time MS pv ...
+//                                         -> bestmove <ruch>|(none)
+//   stop                                  przerywa liczenie, bestmove przychodzi od razu
+//                                         (po go infinite bestmove przychodzi dopiero po stop, nawet gdy
+//                                         liczenie skończyło się wcześniej)
+//   quit
+//
+// Wynik jest z punktu widzenia strony na ruchu; N przy win/loss to półruchy do końca według bazy końcówek.
+// Liczenie idzie w osobnym wątku, a stdin czyta jeszcze inny, więc stop i quit przerywają liczenie od razu;
+// pozostałe polecenia czekają w kolejce na bestmove, więc arbiter może wysyłać je bez czekania na odpowiedź
+// (stop za nimi i tak dociera do liczenia).
+// Koniec wejścia (EOF) też czeka na trwające liczenie; go infinite czeka na stop, więc wtedy EOF i kolejne
+// polecenia działają jak stop.
+
+namespace {
+    std::mutex outputMutex;
+
+    void send(const std::string& line) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << line << std::endl;
+    }
+
+    std::string scoreText(int score, bool whiteTurn) {
+        if (score == INT_MIN + 1 || score == INT_MAX - 1)
+            return (score == INT_MAX - 1) == whiteTurn ? "win" : "loss";
+
+        int own = whiteTurn ? score : -score;
+        if (own >= TB_WIN_SCORE - tb::MAX_DISTANCE - 1 || own <= -(TB_WIN_SCORE - tb::MAX_DISTANCE - 1)) {
+            // wynik z bazy końcówek: liczba półruchów do końca partii
+            int plies = TB_WIN_SCORE - (own > 0 ? own : -own);
+            return std::string(own > 0 ? "win " : "loss ") + std::to_string(plies);
+        }
+        return "cp " + std::to_string(own);
+    }
+
+    class Engine {
+    public:
+        Engine() {
+            notation::parseFen(notation::startFen(), state, whiteTurn);
+        }
+
+        ~Engine() { waitSearch(); }
+
+        // Z wątku czytającego stdin, obok handle: przerywa trwające liczenie, nie czekając na polecenia
+        // przed stop w kolejce. Samo stop z kolejki przyjdzie potem do handle jak zwykle.
+        void interrupt() {
+            search.stop();
+            release();
+        }
+
+        bool handle(const std::string& line) {
+            std::istringstream in(line);
+            std::string command;
+            in >> command;
+
+            if (command == "uci") {
+                send("id name Warcaby");
+                send("option name Hash type spin default 64 min 0 max 4096");
+                send("option name Threads type spin default 1 min 1 max 256");
+                send("option name TablebasePath type string default <empty>");
+                send("option name StatsLog type string default <empty>");
+                send("uciok");
+            }
+            else if (command == "isready") {
+                send("readyok");
+            }
+            else if (command == "setoption") {
+                waitSearch();
+                setOption(in);
+            }
+            else if (command == "ucinewgame") {
+                waitSearch();
+                applyHash();
+                search.clearTT();
+            }
+            else if (command == "position") {
+                waitSearch();
+                setPosition(in);
+            }
+            else if (command == "go") {
+                waitSearch();
+                go(in);
+            }
+            else if (command == "stop") {
+                stopSearch();
+            }
+            else if (command == "quit") {
+                stopSearch();
+                return false;
+            }
+            else if (!command.empty()) {
+                send("info string unknown command " + command);
+            }
+            return true;
+        }
+
+    private:
+        Search search;
+        Tablebase tablebase;
+        std::thread worker;
+        std::ofstream statsLog; // pisze tylko wątek worker, a setoption czeka na jego koniec
+
+        GameState state;
+        bool whiteTurn = true;
+
+        // TT alokowana dopiero przed pierwszym liczeniem - start procesu nie czeka na pamięć
+        int hashMB = 64;
+        int allocatedMB = -1;
+
+        void applyHash() {
+            if (allocatedMB == hashMB) return;
+            search.resizeTT(hashMB);
+            allocatedMB = hashMB;
+        }
+
+        // go infinite: wynik czeka w wątku worker, aż stop zwolni bestmove
+        bool infinite = false;
+        bool holding = false;
+        std::mutex holdMutex;
+        std::condition_variable released;
+
+        void release() {
+            std::lock_guard<std::mutex> lock(holdMutex);
+            holding = false;
+            released.notify_all();
+        }
+
+        void waitSearch() {
+            if (infinite) {
+                stopSearch(); // bez stop liczenie infinite nigdy by się nie skończyło
+                return;
+            }
+            if (worker.joinable())
+                worker.join();
+        }
+
+        void stopSearch() {
+            if (!worker.joinable()) return;
+            search.stop();
+            release();
+            worker.join();
+            infinite = false;
+        }
+
+        void setOption(std::istringstream& in) {
+            std::string token, name, value;
+            in >> token >> name >> token >> value; // name <X> value <N>
+            try {
+                if (name == "Hash")
+                    hashMB = std::clamp(std::stoi(value), 0, 4096);
+                else if (name == "Threads")
+                    search.setThreads(std::clamp(std::stoi(value), 1, 256));
+                else if (name == "TablebasePath") {
+                    tablebase = Tablebase();
+                    int tables = tablebase.load(value);
+                    search.setTablebase(tables > 0 ? &tablebase : nullptr);
+                    send("info string loaded " + std::to_string(tables) + " endgame tables from " + value);
+                }
+                else if (name == "StatsLog") {
+                    statsLog = std::ofstream(value, std::ios::app);
+                    if (!statsLog)
+                        send("info string cannot open " + value);
+                }
+                else
+                    send("info string unknown option " + name);
+            }
+            catch (const std::exception&) {
+                send("info string bad value for " + name);
+            }
+        }
+
+        void setPosition(std::istringstream& in) {
+            std::string token;
+            in >> token;
+
+            GameState next;
+            bool nextWhite = true;
+            if (token == "startpos") {
+                notation::parseFen(notation::startFen(), next, nextWhite);
+            }
+            else if (token == "fen") {
+                std::string fen;
+                in >> fen;
+                if (!notation::parseFen(fen, next, nextWhite)) {
+                    send("info string bad fen " + fen);
+                    return;
+                }
+            }
+            else {
+                send("info string expected startpos or fen");
+                return;
+            }
+
+            in >> token;
+            if (token == "moves") {
+                while (in >> token) {
+                    Move move = notation::parseMove(next, nextWhite, token);
+                    if (move.isNull()) {
+                        send("info string illegal move " + token);
+                        return;
+                    }
+                    next.applyMove(move, nextWhite);
+                    nextWhite = !nextWhite;
+                }
+            }
+
+            state = next;
+            whiteTurn = nextWhite;
+        }
+
+        void go(std::istringstream& in) {
+            infinite = false;
+            int depth = MAX_SEARCH_DEPTH;
+            int movetime = 0;
+            uint64_t nodes = 0;
+
+            std::string token;
+            while (in >> token) {
+                if (token == "depth") in >> depth;
+                else if (token == "movetime") in >> movetime;
+                else if (token == "nodes") in >> nodes;
+                else if (token == "infinite") infinite = true; // do stop, także z bestmove
+            }
+            depth = std::clamp(depth, 1, MAX_SEARCH_DEPTH);
+
+            applyHash();
+            search.clearStop();
+
+            GameState root = state;
+            bool side = whiteTurn;
+            search.setInfoCallback([root, side](const SearchInfo& info) {
+                std::string line = "info depth " + std::to_string(info.depth)
+                    + " score " + scoreText(info.score, side)
+                    + " nodes " + std::to_string(info.nodes)
+                    + " nps " + std::to_string(info.timeMs > 0 ? info.nodes * 1000 / info.timeMs : 0)
+                    + " time " + std::to_string(info.timeMs) + " pv";
+
+                GameState s = root;
+                bool w = side;
+                for (Move m : info.pv) {
+                    line += " " + notation::moveToString(s, w, m);
+                    s.applyMove(m, w);
+                    w = !w;
+                }
+                send(line);
+            });
+
+            {
+                std::lock_guard<std::mutex> lock(holdMutex); // release() może przyjść z wątku czytającego
+                holding = infinite;
+            }
+            worker = std::thread([this, root, side, depth, movetime, nodes]() {
+                SearchResult result = search.run(root, side, depth, movetime, nodes);
+                {
+                    std::unique_lock<std::mutex> lock(holdMutex);
+                    released.wait(lock, [this] { return !holding; });
+                }
+                if (statsLog.is_open())
+                    statsLog << stats::toJson(result, root, side, search.threads()) << std::endl;
+                send("bestmove " + (result.move.isNull() ? std::string("(none)") : notation::moveToString(root, side, result.move)));
+            });
+        }
+    };
+}
+
+int main() {
+    std::ios::sync_with_stdio(false);
+
+    Engine engine;
+    std::mutex queueMutex;
+    std::condition_variable queued;
+    std::deque<std::string> lines;
+    bool eof = false;
+
+    // handle czeka na bestmove przy poleceniach zmieniających stan, więc stdin czyta osobny wątek -
+    // stop i quit trafiają do liczenia od razu, a wszystkie linie i tak idą po kolei do handle
+    std::thread reader([&]() {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            std::istringstream in(line);
+            std::string command;
+            in >> command;
+            if (command == "stop" || command == "quit")
+                engine.interrupt();
+
+            std::lock_guard<std::mutex> lock(queueMutex);
+            lines.push_back(line);
+            queued.notify_one();
+            if (command == "quit") return;
+        }
+        std::lock_guard<std::mutex> lock(queueMutex);
+        eof = true;
+        queued.notify_one();
+    });
+
+    while (true) {
+        std::string line;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queued.wait(lock, [&] { return !lines.empty() || eof; });
+            if (lines.empty()) break;
+            line = std::move(lines.front());
+            lines.pop_front();
+        }
+        if (!engine.handle(line))
+            break;
+    }
+    reader.join();
+    return 0;
+}
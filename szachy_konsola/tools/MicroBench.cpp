@@ -0,0 +1,326 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include "../Search.hpp"
+#include "Positions.hpp"
+
+// Mikrobenchmarki prymitywów silnika na stałym zestawie pozycji (Positions.hpp: pozycje testowe,
+// wszystkie scenariusze z obu stron, pozycje z losowych partii o stałym ziarnie).
+// Każdy pomiar to ROUNDS przebiegów po całym zestawie, powtarzanych tak, żeby przebieg trwał co najmniej
+// MIN_MS; wynik to czas jednego wywołania - najlepszy przebieg (na zaszumionej maszynie najstabilniejszy)
+// i mediana. Suma kontrolna (liczba ruchów, suma ocen, węzły) pilnuje, że porównujemy tę samą pracę.
+//
+// microbench [--rounds N] [--min-ms MS] [--depth N] [--filter TEKST] [--json PLIK]
+// microbench compare BAZA.json NOWY.json [--threshold PROCENT]
+//     porównuje najlepsze czasy; kod 1, gdy coś jest wolniejsze o więcej niż próg (domyślnie 5%)
+
+namespace {
+    struct Options {
+        int rounds = 7;
+        double minMs = 50;
+        int depth = 6; // przeszukiwanie na stałą głębokość, bez limitu czasu
+        std::string filter;
+        std::string json;
+    };
+
+    struct Result {
+        std::string name;
+        uint64_t calls = 0; // wywołań w jednym przebiegu po zestawie
+        double bestNs = 0, medianNs = 0; // na wywołanie
+        uint64_t checksum = 0;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& o) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            try {
+                if (arg == "--rounds") o.rounds = std::max(1, std::stoi(value));
+                else if (arg == "--min-ms") o.minMs = std::max(0.0, std::stod(value));
+                else if (arg == "--depth") o.depth = std::clamp(std::stoi(value), 1, MAX_SEARCH_DEPTH);
+                else if (arg == "--filter") o.filter = value;
+                else if (arg == "--json") o.json = value;
+                else return false;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // fn() to jeden przebieg po zestawie: zwraca liczbę wywołań, a do sum dodaje wyniki (żeby kompilator ich nie wyrzucił)
+    template <typename Fn>
+    Result measure(const std::string& name, const Options& o, Fn fn) {
+        using Clock = std::chrono::steady_clock;
+
+        Result r;
+        r.name = name;
+        Clock::time_point start = Clock::now();
+        r.calls = fn(r.checksum); // rozgrzewka, liczba wywołań i suma kontrolna
+        double onceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        int repeat = std::max(1, int(o.minMs / std::max(onceMs, 1e-3)));
+
+        std::vector<double> perCall;
+        for (int round = 0; round < o.rounds; ++round) {
+            uint64_t sum = 0;
+            start = Clock::now();
+            for (int i = 0; i < repeat; ++i)
+                fn(sum);
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            perCall.push_back(ns / (double(r.calls) * repeat));
+            if (sum != r.checksum * repeat)
+                std::cerr << name << ": checksum changed between rounds\n";
+        }
+
+        std::sort(perCall.begin(), perCall.end());
+        r.bestNs = perCall.front();
+        r.medianNs = perCall[perCall.size() / 2];
+        return r;
+    }
+
+    uint64_t corpusKey(const std::vector<CorpusPosition>& corpus) {
+        uint64_t key = 0;
+        for (const CorpusPosition& p : corpus)
+            key = key * 31 + p.state.key(p.whiteTurn);
+        return key;
+    }
+
+    std::string hex(uint64_t v) {
+        std::ostringstream out;
+        out << "0x" << std::hex << std::setw(16) << std::setfill('0') << v;
+        return out.str();
+    }
+
+    // Jeden pomiar w linii - compare czyta tylko pliki z tego narzędzia, linia po linii
+    bool writeJson(const std::string& path, const Options& o, const std::vector<CorpusPosition>& corpus, const std::vector<Result>& results) {
+        std::ofstream out(path);
+        if (!out) return false;
+
+        out << "{\n  \"build\": \"" << __DATE__ << " " << __TIME__ << "\",\n"
+            << "  \"positions\": " << corpus.size() << ",\n"
+            << "  \"corpus\": \"" << hex(corpusKey(corpus)) << "\",\n"
+            << "  \"rounds\": " << o.rounds << ",\n"
+            << "  \"depth\": " << o.depth << ",\n"
+            << "  \"benchmarks\": [\n" << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"calls\": " << r.calls << ", \"ns_per_call\": " << r.bestNs
+                << ", \"median_ns\": " << r.medianNs << ", \"checksum\": \"" << hex(r.checksum) << "\"}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return bool(out);
+    }
+
+    // Wartość pola "key": z linii JSON - liczba albo tekst w cudzysłowach
+    std::string field(const std::string& line, const std::string& key) {
+        std::string pattern = "\"" + key + "\": ";
+        size_t pos = line.find(pattern);
+        if (pos == std::string::npos) return "";
+        pos += pattern.size();
+        if (line[pos] == '"') {
+            size_t end = line.find('"', pos + 1);
+            return end == std::string::npos ? "" : line.substr(pos + 1, end - pos - 1);
+        }
+        size_t end = line.find_first_of(",}", pos);
+        return line.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    }
+
+    struct Run {
+        std::string corpus, depth;
+        std::vector<Result> results;
+    };
+
+    bool readJson(const std::string& path, Run& run) {
+        std::ifstream in(path);
+        if (!in) return false;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            if (run.corpus.empty()) run.corpus = field(line, "corpus");
+            if (run.depth.empty()) run.depth = field(line, "depth");
+
+            std::string name = field(line, "name");
+            if (name.empty()) continue;
+            Result r;
+            r.name = name;
+            try {
+                r.bestNs = std::stod(field(line, "ns_per_call"));
+                r.checksum = std::stoull(field(line, "checksum"), nullptr, 16);
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+            run.results.push_back(r);
+        }
+        return !run.results.empty();
+    }
+
+    int compare(int argc, char** argv) {
+        double threshold = 5;
+        std::vector<std::string> files;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--threshold" && i + 1 < argc) threshold = std::max(0.0, std::atof(argv[++i]));
+            else files.push_back(arg);
+        }
+        if (files.size() != 2) {
+            std::cerr << "usage: microbench compare BASE.json NEW.json [--threshold PERCENT]\n";
+            return 2;
+        }
+
+        Run base, current;
+        if (!readJson(files[0], base) || !readJson(files[1], current)) {
+            std::cerr << "cannot read " << (base.results.empty() ? files[0] : files[1]) << "\n";
+            return 2;
+        }
+        if (base.corpus != current.corpus || base.depth != current.depth)
+            std::cout << "warning: the runs used different positions or search depth\n\n";
+
+        std::map<std::string, const Result*> before;
+        for (const Result& r : base.results)
+            before[r.name] = &r;
+
+        std::cout << std::left << std::setw(26) << "benchmark" << std::right << std::setw(14) << "base ns"
+            << std::setw(14) << "new ns" << std::setw(10) << "change" << "\n" << std::fixed;
+        int regressions = 0;
+        for (const Result& r : current.results) {
+            std::cout << std::left << std::setw(26) << r.name << std::right;
+            auto it = before.find(r.name);
+            if (it == before.end()) {
+                std::cout << std::setw(14) << "-" << std::setprecision(1) << std::setw(14) << r.bestNs << "  (new)\n";
+                continue;
+            }
+
+            double change = 100.0 * (r.bestNs - it->second->bestNs) / it->second->bestNs;
+            std::cout << std::setprecision(1) << std::setw(14) << it->second->bestNs << std::setw(14) << r.bestNs
+                << std::showpos << std::setw(9) << change << "%" << std::noshowpos;
+            if (change > threshold) {
+                std::cout << "  REGRESSION";
+                ++regressions;
+            }
+            if (r.checksum != it->second->checksum)
+                std::cout << "  (different result)"; // generator albo ocena liczą coś innego - czasy nieporównywalne
+            std::cout << "\n";
+            before.erase(it);
+        }
+        for (const auto& missing : before)
+            std::cout << std::left << std::setw(26) << missing.first << std::right << "  (missing)\n";
+
+        if (regressions) {
+            std::cout << "\n" << regressions << " benchmarks slower by more than " << std::setprecision(1) << threshold << "%\n";
+            return 1;
+        }
+        std::cout << "\nno regressions above " << std::setprecision(1) << threshold << "%\n";
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "compare")
+        return compare(argc, argv);
+
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        std::cerr << "usage: microbench [--rounds N] [--min-ms MS] [--depth N] [--filter TEXT] [--json FILE]\n"
+                     "       microbench compare BASE.json NEW.json [--threshold PERCENT]\n";
+        return 2;
+    }
+
+    std::vector<CorpusPosition> corpus = corpusPositions(), captures;
+    std::copy_if(corpus.begin(), corpus.end(), std::back_inserter(captures),
+        [](const CorpusPosition& p) { return p.state.hasCapture(p.whiteTurn); });
+    std::vector<CorpusPosition> fixed = corpusPositions(0); // bez losowych partii - przeszukiwanie jest drogie
+
+    // Ruchy każdej pozycji policzone z góry, żeby applyMove/undoMove mierzyło tylko siebie
+    std::vector<std::vector<Move>> moves(corpus.size());
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        MoveList list;
+        corpus[i].state.generateMoves(corpus[i].whiteTurn, list);
+        moves[i].assign(list.begin(), list.end());
+    }
+
+    Search search;
+    search.resizeTT(16);
+    search.setThreads(1);
+
+    std::cout << "Microbenchmarks on " << corpus.size() << " positions (" << captures.size() << " with a capture), best and median of "
+        << o.rounds << " rounds, ns per call\n\n";
+    std::cout << std::left << std::setw(26) << "benchmark" << std::right << std::setw(10) << "calls"
+        << std::setw(14) << "best ns" << std::setw(14) << "median ns" << "\n" << std::fixed;
+
+    std::vector<Result> results;
+    auto run = [&](const std::string& name, auto fn) {
+        if (!o.filter.empty() && name.find(o.filter) == std::string::npos) return;
+        Result r = measure(name, o, fn);
+        std::cout << std::left << std::setw(26) << r.name << std::right << std::setw(10) << r.calls << std::setprecision(1)
+            << std::setw(14) << r.bestNs << std::setw(14) << r.medianNs << std::endl;
+        results.push_back(r);
+    };
+
+    auto generate = [](const std::vector<CorpusPosition>& positions) {
+        return [&positions](uint64_t& sum) {
+            for (const CorpusPosition& p : positions) {
+                MoveList list;
+                p.state.generateMoves(p.whiteTurn, list);
+                sum += list.size();
+            }
+            return uint64_t(positions.size());
+        };
+    };
+    run("generateMoves", generate(corpus));
+    run("generateMoves/capture", generate(captures));
+
+    run("hasCapture", [&](uint64_t& sum) {
+        for (const CorpusPosition& p : corpus)
+            sum += p.state.hasCapture(p.whiteTurn);
+        return uint64_t(corpus.size());
+    });
+    run("evaluate", [&](uint64_t& sum) {
+        for (const CorpusPosition& p : corpus)
+            sum += uint64_t(p.state.evaluate());
+        return uint64_t(corpus.size());
+    });
+    run("applyMove+undoMove", [&](uint64_t& sum) {
+        uint64_t calls = 0;
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            GameState& state = corpus[i].state;
+            for (Move m : moves[i]) {
+                GameState::MoveBackup backup = state.applyMove(m, corpus[i].whiteTurn);
+                sum += state.hash;
+                state.undoMove(backup);
+            }
+            calls += moves[i].size();
+        }
+        return calls;
+    });
+
+    // Przeszukiwanie od czystej TT, więc liczba węzłów (suma kontrolna) jest powtarzalna
+    run("search/depth" + std::to_string(o.depth), [&](uint64_t& sum) {
+        for (const CorpusPosition& p : fixed) {
+            search.clearTT();
+            sum += search.run(p.state, p.whiteTurn, o.depth, 0).nodes;
+        }
+        return uint64_t(fixed.size());
+    });
+
+    if (!o.json.empty()) {
+        if (!writeJson(o.json, o, corpus, results)) {
+            std::cerr << "cannot write " << o.json << "\n";
+            return 1;
+        }
+        std::cout << "\nwrote " << o.json << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,366 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../GameState.hpp"
+#include "../Scenarios.hpp"
+#include "Rules.hpp"
+
+// Perft: liczba liści drzewa ruchów do zadanej głębokości - sprawdza generateMoves
+// i applyMove/undoMove bez GUI. Bicie wielokrotne to jeden ruch (cała droga skoków).
+// Tabela wzorcowa sprawdza też rules::Position<English> (Rules.hpp) - musi liczyć to samo co GameState -
+// oraz warcaby międzynarodowe 10x10 z pozycji startowej.
+//
+// perft                                 sprawdza tabelę wzorcowych wyników (kod 1 przy różnicy)
+// perft <start|1..11> <głębokość> [divide] [bulk] [black]
+// perft <start|FEN> <głębokość> international [divide] [bulk] [black]
+
+struct PerftStats {
+    uint64_t leaves = 0;
+    uint64_t nodes = 0; // wszystkie odwiedzone pozycje
+    uint64_t truncated = 0; // listy ruchów, które nie zmieściły wszystkich ruchów - wynik jest wtedy za mały
+};
+
+// bulk: na ostatnim poziomie liczymy ruchy bez wykonywania
+static void perft(GameState& state, int depth, bool whiteTurn, bool bulk, PerftStats& stats) {
+    ++stats.nodes;
+    if (depth == 0) {
+        ++stats.leaves;
+        return;
+    }
+
+    MoveList moves;
+    state.generateMoves(whiteTurn, moves);
+    stats.truncated += moves.truncated();
+    if (bulk && depth == 1) {
+        stats.leaves += moves.size();
+        return;
+    }
+
+    for (Move move : moves) {
+        GameState::MoveBackup backup = state.applyMove(move, whiteTurn);
+        perft(state, depth - 1, !whiteTurn, bulk, stats);
+        state.undoMove(backup);
+    }
+}
+
+// To samo na szablonie reguł; pozycja kopiowana w dół drzewa zamiast undoMove
+template <typename V>
+static void perft(const rules::Position<V>& pos, int depth, bool whiteTurn, bool bulk, PerftStats& stats) {
+    ++stats.nodes;
+    if (depth == 0) {
+        ++stats.leaves;
+        return;
+    }
+
+    rules::MoveList<V> moves;
+    pos.generateMoves(whiteTurn, moves);
+    stats.truncated += moves.truncated();
+    if (bulk && depth == 1) {
+        stats.leaves += moves.size();
+        return;
+    }
+
+    for (const rules::Move<V>& move : moves) {
+        rules::Position<V> next = pos;
+        next.apply(move, whiteTurn);
+        perft(next, depth - 1, !whiteTurn, bulk, stats);
+    }
+}
+
+static std::string squareName(int sq) {
+    // kolumny a-h od lewej, wiersze 8-1 od góry
+    return std::string(1, char('a' + bb::col(sq))) + char('8' - bb::row(sq));
+}
+
+static bool setup(GameState& state, const std::string& name) {
+    if (name == "start") {
+        scenario::startPosition(state);
+        return true;
+    }
+    try {
+        return scenario::load(state, std::stoi(name));
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+// Przepełniona lista ruchów gubi ruchy, więc liczba liści jest niepełna
+static int reportTruncated(const PerftStats& stats) {
+    if (!stats.truncated) return 0;
+    std::cout << "*** " << stats.truncated << " move lists overflowed - count is incomplete ***\n";
+    return 1;
+}
+
+struct Timed {
+    PerftStats stats;
+    double seconds = 0;
+};
+
+template <typename State>
+static Timed timedPerft(State& state, int depth, bool whiteTurn, bool bulk) {
+    using Clock = std::chrono::steady_clock;
+
+    Timed t;
+    Clock::time_point start = Clock::now();
+    perft(state, depth, whiteTurn, bulk, t.stats);
+    t.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return t;
+}
+
+static double perSecond(uint64_t count, double seconds) {
+    return seconds > 0 ? count / seconds : 0.0;
+}
+
+// Wzorcowe wyniki. Każda zmiana generatora ruchów musi je zachować.
+struct Reference {
+    const char* position;
+    bool whiteTurn;
+    int depth;
+    uint64_t leaves;
+};
+
+static const std::vector<Reference> REFERENCE = {
+    { "start", true, 1, 7 },
+    { "start", true, 2, 49 },
+    { "start", true, 3, 302 },
+    { "start", true, 4, 1469 },
+    { "start", true, 5, 7361 },
+    { "start", true, 6, 36768 },
+    { "start", true, 7, 179740 },
+    { "start", true, 8, 845931 },
+    { "start", true, 9, 3963629 },
+    { "1", true, 1, 1 },
+    { "1", true, 2, 0 },
+    { "1", false, 1, 1 },
+    { "1", false, 2, 1 },
+    { "1", false, 3, 2 },
+    { "1", false, 4, 4 },
+    { "1", false, 6, 9 },
+    { "1", false, 8, 72 },
+    { "1", false, 10, 300 },
+    { "2", true, 1, 1 },
+    { "2", true, 2, 2 },
+    { "2", true, 3, 4 },
+    { "2", true, 4, 8 },
+    { "2", true, 6, 28 },
+    { "2", true, 8, 196 },
+    { "2", true, 10, 2100 },
+    { "2", false, 1, 1 },
+    { "2", false, 2, 0 },
+    { "3", true, 1, 2 },
+    { "3", true, 2, 0 },
+    { "3", false, 1, 0 },
+    { "4", true, 1, 1 },
+    { "4", true, 2, 0 },
+    { "4", false, 1, 1 },
+    { "4", false, 2, 0 },
+    { "5", true, 1, 2 },
+    { "5", true, 2, 0 },
+    { "5", false, 1, 0 },
+    { "6", true, 1, 4 },
+    { "6", true, 2, 0 },
+    { "6", false, 1, 0 },
+    { "7", true, 1, 2 },
+    { "7", true, 2, 4 },
+    { "7", true, 3, 16 },
+    { "7", true, 4, 31 },
+    { "7", true, 6, 161 },
+    { "7", true, 8, 1600 },
+    { "7", true, 10, 14342 },
+    { "7", false, 1, 3 },
+    { "7", false, 2, 3 },
+    { "7", false, 3, 6 },
+    { "7", false, 4, 24 },
+    { "7", false, 6, 144 },
+    { "7", false, 8, 1509 },
+    { "7", false, 10, 13417 },
+    { "8", true, 1, 1 },
+    { "8", true, 2, 0 },
+    { "8", false, 1, 1 },
+    { "8", false, 2, 3 },
+    { "8", false, 3, 6 },
+    { "8", false, 4, 18 },
+    { "8", false, 6, 120 },
+    { "8", false, 8, 700 },
+    { "8", false, 10, 9632 },
+    { "9", true, 1, 2 },
+    { "9", true, 2, 2 },
+    { "9", true, 3, 4 },
+    { "9", true, 4, 4 },
+    { "9", true, 6, 16 },
+    { "9", true, 8, 126 },
+    { "9", true, 10, 1440 },
+    { "9", false, 1, 2 },
+    { "9", false, 2, 2 },
+    { "9", false, 3, 4 },
+    { "9", false, 4, 6 },
+    { "9", false, 6, 20 },
+    { "9", false, 8, 140 },
+    { "9", false, 10, 1518 },
+    { "10", true, 1, 1 },
+    { "10", true, 2, 0 },
+    { "10", false, 1, 1 },
+    { "10", false, 2, 2 },
+    { "10", false, 3, 4 },
+    { "10", false, 4, 6 },
+    { "10", false, 6, 18 },
+    { "10", false, 8, 120 },
+    { "10", false, 10, 600 },
+    { "11", true, 1, 1 },
+    { "11", true, 2, 0 },
+    { "11", false, 1, 1 },
+    { "11", false, 2, 0 },
+};
+
+// Warcaby międzynarodowe z pozycji startowej (białe zaczynają)
+static const std::vector<uint64_t> INTERNATIONAL_REFERENCE = { 9, 81, 658, 4265, 27117, 167140, 1049442 };
+
+static int checkReference() {
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+
+    for (const Reference& ref : REFERENCE) {
+        GameState state;
+        setup(state, ref.position);
+        uint64_t keyBefore = state.key(true);
+
+        Timed full = timedPerft(state, ref.depth, ref.whiteTurn, false);
+        Timed bulk = timedPerft(state, ref.depth, ref.whiteTurn, true);
+        totalNodes += full.stats.nodes;
+        totalSeconds += full.seconds;
+
+        rules::Position<rules::English> generic;
+        generic.white = state.pos.white;
+        generic.black = state.pos.black;
+        generic.kings = state.pos.kings;
+        Timed templated = timedPerft(generic, ref.depth, ref.whiteTurn, true);
+
+        bool ok = full.stats.leaves == ref.leaves && bulk.stats.leaves == ref.leaves && templated.stats.leaves == ref.leaves
+            && state.key(true) == keyBefore;
+        std::cout << (ok ? "ok    " : "FAIL  ") << std::left << std::setw(6) << ref.position
+            << (ref.whiteTurn ? " white" : " black") << " depth " << std::setw(3) << ref.depth << std::right << std::setw(14) << full.stats.leaves;
+        if (!ok) {
+            std::cout << "  expected " << ref.leaves << ", bulk " << bulk.stats.leaves << ", rules::English " << templated.stats.leaves;
+            if (state.key(true) != keyBefore)
+                std::cout << ", undoMove did not restore the position";
+            ++failures;
+        }
+        std::cout << "\n";
+    }
+
+    using International = rules::Position<rules::International>;
+    for (size_t i = 0; i < INTERNATIONAL_REFERENCE.size(); ++i) {
+        International start = International::start();
+        Timed t = timedPerft(start, int(i) + 1, true, true);
+        bool ok = t.stats.leaves == INTERNATIONAL_REFERENCE[i];
+        std::cout << (ok ? "ok    " : "FAIL  ") << "10x10  white depth " << std::left << std::setw(3) << i + 1 << std::right
+            << std::setw(14) << t.stats.leaves;
+        if (!ok) {
+            std::cout << "  expected " << INTERNATIONAL_REFERENCE[i];
+            ++failures;
+        }
+        std::cout << "\n";
+    }
+
+    size_t total = REFERENCE.size() + INTERNATIONAL_REFERENCE.size();
+    std::cout << "\n" << std::fixed << std::setprecision(0) << perSecond(totalNodes, totalSeconds) << " nodes/s\n";
+    if (failures) {
+        std::cout << "\n*** PERFT MISMATCH: " << failures << " of " << total << " reference counts differ ***\n";
+        return 1;
+    }
+    std::cout << "all " << total << " reference counts match\n";
+    return 0;
+}
+
+// perft dla wariantu z Rules.hpp: pozycja startowa albo FEN (wtedy strona na ruchu z FEN)
+template <typename V>
+static int runVariant(const std::string& name, int depth, bool divide, bool bulk, bool whiteTurn) {
+    rules::Position<V> pos = rules::Position<V>::start();
+    if ((name != "start" && !rules::parseFen(name, pos, whiteTurn)) || depth < 1) {
+        std::cerr << "usage: perft <start|FEN> <depth> " << V::NAME << " [divide] [bulk] [black]\n";
+        return 2;
+    }
+
+    std::cout << std::fixed << std::setprecision(0);
+
+    if (divide) {
+        uint64_t total = 0;
+        rules::MoveList<V> moves;
+        pos.generateMoves(whiteTurn, moves);
+        for (const rules::Move<V>& move : moves) {
+            PerftStats stats;
+            rules::Position<V> next = pos;
+            next.apply(move, whiteTurn);
+            perft(next, depth - 1, !whiteTurn, bulk, stats);
+            std::cout << rules::moveToString(move) << ": " << stats.leaves << "\n";
+            total += stats.leaves;
+        }
+        std::cout << "\ntotal: " << total << "\n";
+        return 0;
+    }
+
+    Timed t = timedPerft(pos, depth, whiteTurn, bulk);
+    std::cout << "perft(" << depth << ") = " << t.stats.leaves << "\n"
+        << t.stats.nodes << " nodes in " << std::setprecision(3) << t.seconds << " s, " << std::setprecision(0)
+        << perSecond(t.stats.nodes, t.seconds) << " nodes/s, " << perSecond(t.stats.leaves, t.seconds) << " leaves/s\n";
+    return reportTruncated(t.stats);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3)
+        return checkReference();
+
+    std::string name = argv[1];
+    int depth = std::stoi(argv[2]);
+    bool divide = false, bulk = false, whiteTurn = true, international = false;
+    for (int i = 3; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (opt == "divide") divide = true;
+        else if (opt == "bulk") bulk = true;
+        else if (opt == "black") whiteTurn = false;
+        else if (opt == "international") international = true;
+        else {
+            std::cerr << "Unknown option: " << opt << "\n";
+            return 2;
+        }
+    }
+
+    if (international)
+        return runVariant<rules::International>(name, depth, divide, bulk, whiteTurn);
+
+    GameState state;
+    if (!setup(state, name) || depth < 1) {
+        std::cerr << "usage: perft <start|1.." << scenario::COUNT << "> <depth> [divide] [bulk] [black]\n";
+        return 2;
+    }
+
+    std::cout << std::fixed << std::setprecision(0);
+
+    if (divide) {
+        uint64_t total = 0;
+        MoveList moves;
+        state.generateMoves(whiteTurn, moves);
+        for (Move move : moves) {
+            PerftStats stats;
+            GameState::MoveBackup backup = state.applyMove(move, whiteTurn);
+            perft(state, depth - 1, !whiteTurn, bulk, stats);
+            state.undoMove(backup);
+
+            std::cout << squareName(move.from()) << (move.isCapture() ? "x" : "-") << squareName(move.to())
+                << ": " << stats.leaves << "\n";
+            total += stats.leaves;
+        }
+        std::cout << "\ntotal: " << total << "\n";
+        return 0;
+    }
+
+    Timed t = timedPerft(state, depth, whiteTurn, bulk);
+    std::cout << "perft(" << depth << ") = " << t.stats.leaves << "\n"
+        << t.stats.nodes << " nodes in " << std::setprecision(3) << t.seconds << " s, " << std::setprecision(0)
+        << perSecond(t.stats.nodes, t.seconds) << " nodes/s, " << perSecond(t.stats.leaves, t.seconds) << " leaves/s\n";
+    return reportTruncated(t.stats);
+}
@@ -0,0 +1,118 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+#include <random>
+#include "../GameState.hpp"
+#include "../Scenarios.hpp"
+
+// Stałe pozycje dla narzędzi (benchmark, perft). Znaki jak w Board::pieceToStr:
+// wiersz 0 u góry (czarne startują na górze), o/O = biały pionek/damka, x/X = czarny, '.' = puste.
+struct TestPosition {
+    const char* name;
+    const char* rows[8];
+    bool whiteTurn;
+};
+
+inline const std::vector<TestPosition>& testPositions() {
+    static const std::vector<TestPosition> positions = {
+        { "start", {
+            ".x.x.x.x",
+            "x.x.x.x.",
+            ".x.x.x.x",
+            "........",
+            "........",
+            "o.o.o.o.",
+            ".o.o.o.o",
+            "o.o.o.o." }, true },
+        { "opening", {
+            ".x.x.x.x",
+            "x.x.x.x.",
+            "...x.x.x",
+            "..x.....",
+            ".o......",
+            "..o.o.o.",
+            ".o.o.o.o",
+            "o.o.o.o." }, true },
+        { "middlegame", {
+            ".x.x.x..",
+            "x...x.x.",
+            ".x...x.x",
+            "x.x.....",
+            ".....o.o",
+            "o.o.o...",
+            ".o...o.o",
+            "o.o....." }, false },
+        { "kings", {
+            "........",
+            "..x.x...",
+            ".X......",
+            "........",
+            "...o....",
+            "o.....O.",
+            ".o......",
+            "........" }, true },
+    };
+    return positions;
+}
+
+// false przy błędnym znaku albo figurze na jasnym polu
+inline bool setupPosition(GameState& state, const char* const rows[8]) {
+    state.clear();
+    for (int r = 0; r < 8; ++r) {
+        for (int c = 0; c < 8; ++c) {
+            char ch = rows[r][c];
+            if (ch == '.') continue;
+
+            int sq = bb::square(r, c);
+            if (sq < 0) return false;
+            switch (ch) {
+            case 'o': state.putPiece(sq, true, false); break;
+            case 'O': state.putPiece(sq, true, true); break;
+            case 'x': state.putPiece(sq, false, false); break;
+            case 'X': state.putPiece(sq, false, true); break;
+            default: return false;
+            }
+        }
+    }
+    return true;
+}
+
+struct CorpusPosition {
+    std::string name;
+    GameState state;
+    bool whiteTurn;
+};
+
+// Zestaw do pomiarów (bench primitives, microbench): pozycje testowe, każdy scenariusz z obu stron
+// i pozycje z randomGames losowych partii od startu o stałym ziarnie - dużo z nich ma bicie, czyli drogi skoków.
+// Domyślnie 2566 pozycji: 26 stałych i 2540 z partii (do 80 półruchów każda)
+inline std::vector<CorpusPosition> corpusPositions(int randomGames = 40) {
+    std::vector<CorpusPosition> corpus;
+    for (const TestPosition& tp : testPositions()) {
+        GameState state;
+        if (setupPosition(state, tp.rows))
+            corpus.push_back({ tp.name, state, tp.whiteTurn });
+    }
+    for (int id = 1; id <= scenario::COUNT; ++id) {
+        GameState state;
+        scenario::load(state, id);
+        corpus.push_back({ "scenario " + std::to_string(id) + " white", state, true });
+        corpus.push_back({ "scenario " + std::to_string(id) + " black", state, false });
+    }
+
+    std::mt19937 rng(12345);
+    for (int game = 0; game < randomGames; ++game) {
+        GameState state;
+        scenario::startPosition(state);
+        bool whiteTurn = true;
+        for (int ply = 0; ply < 80; ++ply) {
+            MoveList moves;
+            state.generateMoves(whiteTurn, moves);
+            if (moves.empty()) break;
+            corpus.push_back({ "game " + std::to_string(game + 1) + " ply " + std::to_string(ply), state, whiteTurn });
+            state.applyMove(moves[int(rng() % moves.size())], whiteTurn);
+            whiteTurn = !whiteTurn;
+        }
+    }
+    return corpus;
+}
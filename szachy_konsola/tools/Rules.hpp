@@ -0,0 +1,318 @@
+﻿#pragma once
+#include <cassert>
+#include <sstream>
+#include <string>
+#include "../Geometry.hpp"
+
+// Referencyjny generator ruchów do perft, jako szablon na wariant reguł: ruchy, bicie i wykonanie ruchu
+// dla planszy dowolnego rozmiaru (geometria z Geometry.hpp, flagi reguł niżej). Używa go tylko tools/Perft.cpp.
+//
+// Gra, przeszukiwanie, silnik i okno stoją na GameState (przesunięcia bitboardów 8x8, licznik materiału,
+// Zobrist) i grają wyłącznie 8x8; nie da się w nich zagrać ani liczyć 10x10. rules::Position<English>
+// to druga, niezależna implementacja tych samych reguł - perft sprawdza na wszystkich pozycjach wzorcowych,
+// że generuje dokładnie to co GameState. rules::Position<International> liczy perft 10x10.
+namespace rules {
+
+    // Reguły gry w GameState: piony biją tylko do przodu, damki o jedno pole, bez obowiązku bicia
+    // największej liczby figur. Zbita figura znika od razu, a pion, który doszedł do końca, bije dalej jako damka.
+    struct English {
+        using Geo = Board8; // ta sama plansza co GameState
+        static constexpr const char* NAME = "english";
+        static constexpr bool FLYING_KINGS = false;
+        static constexpr bool MEN_CAPTURE_BACKWARD = false;
+        static constexpr bool MAXIMUM_CAPTURE = false;
+        static constexpr bool PROMOTE_DURING_CAPTURE = true;
+        static constexpr bool REMOVE_DURING_CAPTURE = true;
+        static constexpr bool UNIQUE_CAPTURES = false; // różne drogi do tych samych zbitych to osobne ruchy, jak w generateMoves
+    };
+
+    // Warcaby międzynarodowe 10x10: damki dalekiego zasięgu, piony biją też do tyłu, obowiązek bicia
+    // największej liczby figur. Zbite figury schodzą dopiero po turze (blokują, nie można ich bić drugi raz),
+    // a pion promuje tylko wtedy, gdy kończy turę na ostatnim wierszu.
+    struct International {
+        using Geo = Geometry<10>;
+        static constexpr const char* NAME = "international";
+        static constexpr bool FLYING_KINGS = true;
+        static constexpr bool MEN_CAPTURE_BACKWARD = true;
+        static constexpr bool MAXIMUM_CAPTURE = true;
+        static constexpr bool PROMOTE_DURING_CAPTURE = false;
+        static constexpr bool REMOVE_DURING_CAPTURE = false;
+        static constexpr bool UNIQUE_CAPTURES = true; // ruch to skąd, dokąd i zbite pola, jak w zapisie PDN
+    };
+
+    template <typename B>
+    inline int popCount(B b) {
+        if constexpr (sizeof(B) > 4)
+            return bb::popCount(uint32_t(b)) + bb::popCount(uint32_t(b >> 32));
+        else
+            return bb::popCount(b);
+    }
+
+    template <typename B>
+    inline int popLsb(B& b) {
+        int sq;
+        if constexpr (sizeof(B) > 4)
+            sq = uint32_t(b) ? bb::lsb(uint32_t(b)) : 32 + bb::lsb(uint32_t(b >> 32));
+        else
+            sq = bb::lsb(b);
+        b &= b - 1;
+        return sq;
+    }
+
+    template <typename V>
+    struct Move {
+        using Bits = typename V::Geo::Bits;
+
+        int8_t from = -1, to = -1;
+        bool promotes = false; // pion kończy turę jako damka
+        Bits captured = 0;
+
+        bool isCapture() const { return captured != 0; }
+        bool operator==(const Move& o) const { return from == o.from && to == o.to && captured == o.captured; }
+    };
+
+    // Jak ::MoveList - stała pojemność na stosie, nadmiarowy ruch przepada i ustawia truncated().
+    // Damki dalekiego zasięgu mają do 4 * 9 ruchów, stąd więcej miejsca.
+    template <typename V>
+    class MoveList {
+    public:
+        static constexpr int CAPACITY = 256;
+
+        MoveList() {}
+
+        void add(const Move<V>& m) {
+            assert(count < CAPACITY);
+            if (count < CAPACITY) moves[count++] = m;
+            else overflowed = true;
+        }
+        // Przy obowiązku największego bicia czyści krótsze drogi - te, które się nie zmieściły, też były krótsze
+        void clear() {
+            count = 0;
+            overflowed = false;
+        }
+
+        int size() const { return count; }
+        bool truncated() const { return overflowed; }
+        bool empty() const { return count == 0; }
+
+        const Move<V>& operator[](int i) const { return moves[i]; }
+        const Move<V>* begin() const { return moves; }
+        const Move<V>* end() const { return moves + count; }
+
+    private:
+        union { Move<V> moves[CAPACITY]; };
+        int count = 0;
+        bool overflowed = false;
+    };
+
+    template <typename V>
+    class Position {
+    public:
+        using G = typename V::Geo;
+        using Bits = typename G::Bits;
+
+        Bits white = 0;
+        Bits black = 0;
+        Bits kings = 0; // podzbiór white | black
+
+        // Piony na wierszach od brzegu do środka bez dwóch środkowych (8x8: po 12, 10x10: po 20)
+        static Position start() {
+            Position p;
+            for (int sq = 0; sq < G::SQUARES; ++sq) {
+                if (G::row(sq) < G::SIZE / 2 - 1) p.black |= G::bit(sq);
+                else if (G::row(sq) > G::SIZE / 2) p.white |= G::bit(sq);
+            }
+            return p;
+        }
+
+        Bits occupied() const { return white | black; }
+        Bits pieces(bool whiteSide) const { return whiteSide ? white : black; }
+
+        bool hasCapture(bool whiteTurn) const {
+            Bits own = pieces(whiteTurn), enemy = pieces(!whiteTurn), occ = occupied();
+            while (own) {
+                int sq = popLsb(own);
+                bool king = (kings & G::bit(sq)) != 0;
+                for (int d = 0; d < 4; ++d) {
+                    if (!king && !V::MEN_CAPTURE_BACKWARD && !bb::isForward(d, whiteTurn)) continue;
+
+                    int over = STEP<G>(sq, d);
+                    if (V::FLYING_KINGS && king) {
+                        while (over >= 0 && !(occ & G::bit(over)))
+                            over = STEP<G>(over, d);
+                    }
+                    if (over < 0 || !(enemy & G::bit(over))) continue;
+                    int land = STEP<G>(over, d);
+                    if (land >= 0 && !(occ & G::bit(land)))
+                        return true;
+                }
+            }
+            return false;
+        }
+
+        // Całe tury jak GameState::generateMoves: przy biciu każda pełna droga (obowiązkowe), inaczej ruchy ciche.
+        // Lista ma być pusta - przy obowiązku największego bicia krótsze drogi są z niej usuwane.
+        void generateMoves(bool whiteTurn, MoveList<V>& moves) const {
+            Bits own = pieces(whiteTurn);
+
+            if (hasCapture(whiteTurn)) {
+                int best = 0;
+                Bits from = own;
+                while (from) {
+                    int sq = popLsb(from);
+                    bool king = (kings & G::bit(sq)) != 0;
+                    addCaptures(moves, best, own & ~G::bit(sq), sq, sq, whiteTurn, king, 0);
+                }
+                return;
+            }
+
+            Bits occ = occupied();
+            while (own) {
+                int sq = popLsb(own);
+                bool king = (kings & G::bit(sq)) != 0;
+                for (int d = 0; d < 4; ++d) {
+                    if (!king && !bb::isForward(d, whiteTurn)) continue;
+                    for (int to = STEP<G>(sq, d); to >= 0 && !(occ & G::bit(to)); to = STEP<G>(to, d)) {
+                        moves.add({ int8_t(sq), int8_t(to), !king && (PROMOTION<G>[whiteTurn] & G::bit(to)) != 0, 0 });
+                        if (!(V::FLYING_KINGS && king)) break;
+                    }
+                }
+            }
+        }
+
+        void apply(const Move<V>& m, bool whiteTurn) {
+            Bits fromBit = G::bit(m.from), toBit = G::bit(m.to);
+            Bits& own = whiteTurn ? white : black;
+            Bits& opp = whiteTurn ? black : white;
+            bool king = (kings & fromBit) || m.promotes;
+
+            own &= ~fromBit; // damka może wrócić bijąc na pole startowe
+            kings &= ~fromBit;
+            own |= toBit;
+            if (king) kings |= toBit;
+
+            opp &= ~m.captured;
+            kings &= ~m.captured;
+        }
+
+    private:
+        // Jeden skok drogi bicia z pola sq. ownRest to własne figury bez bijącej; zbite (captured) zależnie
+        // od wariantu znikają od razu albo zostają na planszy jako przeszkoda do końca tury.
+        void addCaptures(MoveList<V>& moves, int& best, Bits ownRest, int start, int sq, bool whiteTurn, bool king, Bits captured) const {
+            Bits enemy = pieces(!whiteTurn) & ~captured;
+            Bits occ = ownRest | enemy | (V::REMOVE_DURING_CAPTURE ? 0 : captured);
+            bool extended = false;
+
+            for (int d = 0; d < 4; ++d) {
+                if (!king && !V::MEN_CAPTURE_BACKWARD && !bb::isForward(d, whiteTurn)) continue;
+
+                int over = STEP<G>(sq, d);
+                if (V::FLYING_KINGS && king) {
+                    while (over >= 0 && !(occ & G::bit(over)))
+                        over = STEP<G>(over, d);
+                }
+                if (over < 0 || !(enemy & G::bit(over))) continue;
+
+                for (int land = STEP<G>(over, d); land >= 0 && !(occ & G::bit(land)); land = STEP<G>(land, d)) {
+                    bool nowKing = king || (V::PROMOTE_DURING_CAPTURE && (PROMOTION<G>[whiteTurn] & G::bit(land)));
+                    addCaptures(moves, best, ownRest, start, land, whiteTurn, nowKing, captured | G::bit(over));
+                    extended = true;
+                    if (!(V::FLYING_KINGS && king)) break;
+                }
+            }
+
+            if (extended || !captured) return;
+
+            // Bicie kończy się dopiero, gdy nie ma dalszego skoku
+            if (V::MAXIMUM_CAPTURE) {
+                int count = popCount(captured);
+                if (count < best) return;
+                if (count > best) {
+                    moves.clear();
+                    best = count;
+                }
+            }
+
+            bool wasKing = (kings & G::bit(start)) != 0;
+            Move<V> m{ int8_t(start), int8_t(sq), !wasKing && (king || (PROMOTION<G>[whiteTurn] & G::bit(sq))), captured };
+            if (V::UNIQUE_CAPTURES) {
+                for (const Move<V>& other : moves)
+                    if (other == m) return;
+            }
+            moves.add(m);
+        }
+    };
+
+    // Zapis jak w Notation.hpp, z numerami pól 1..SQUARES: "W:W31,32,K40:B1,2" i "32-28" / "28x19"
+
+    template <typename V>
+    std::string toFen(const Position<V>& p, bool whiteTurn) {
+        std::string fen = whiteTurn ? "W" : "B";
+        for (bool white : { true, false }) {
+            fen += white ? ":W" : ":B";
+            auto pieces = p.pieces(white);
+            for (bool first = true; pieces; first = false) {
+                int sq = popLsb(pieces);
+                fen += (first ? "" : ",") + std::string(p.kings & V::Geo::bit(sq) ? "K" : "") + std::to_string(sq + 1);
+            }
+        }
+        return fen;
+    }
+
+    // Numer pola 1..SQUARES jako indeks; -1 dla czegokolwiek innego
+    template <typename G>
+    int parseSquare(const std::string& text) {
+        if (text.empty() || text.size() > 2 || text.find_first_not_of("0123456789") != std::string::npos) return -1;
+        int n = std::stoi(text);
+        return (n >= 1 && n <= G::SQUARES) ? n - 1 : -1;
+    }
+
+    // false = błędny zapis, pozycja bez zmian
+    template <typename V>
+    bool parseFen(const std::string& fen, Position<V>& result, bool& whiteTurn) {
+        using G = typename V::Geo;
+        std::stringstream ss(fen);
+        std::string field;
+        if (!std::getline(ss, field, ':') || (field != "W" && field != "B"))
+            return false;
+        bool turn = field == "W";
+
+        Position<V> p;
+        while (std::getline(ss, field, ':')) {
+            if (field.empty() || (field[0] != 'W' && field[0] != 'B'))
+                return false;
+            bool white = field[0] == 'W';
+
+            std::stringstream items(field.substr(1));
+            std::string item;
+            while (std::getline(items, item, ',')) {
+                if (item.empty()) continue;
+                bool king = item[0] == 'K';
+                if (king) item.erase(0, 1);
+
+                // PDN pozwala też na zakresy: "31-50"
+                size_t dash = item.find('-');
+                int first = parseSquare<G>(item.substr(0, dash));
+                int last = dash == std::string::npos ? first : parseSquare<G>(item.substr(dash + 1));
+                if (first < 0 || last < first)
+                    return false;
+
+                for (int sq = first; sq <= last; ++sq) {
+                    if (p.occupied() & G::bit(sq))
+                        return false;
+                    (white ? p.white : p.black) |= G::bit(sq);
+                    if (king) p.kings |= G::bit(sq);
+                }
+            }
+        }
+
+        result = p;
+        whiteTurn = turn;
+        return true;
+    }
+
+    template <typename V>
+    std::string moveToString(const Move<V>& m) {
+        return std::to_string(m.from + 1) + (m.isCapture() ? "x" : "-") + std::to_string(m.to + 1);
+    }
+}
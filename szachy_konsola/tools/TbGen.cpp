@@ -0,0 +1,381 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <filesystem>
+#include "../GameState.hpp"
+#include "../Tablebase.hpp"
+
+// Generator baz końcówek: analiza wsteczna dla wszystkich układów materiału do N figur.
+// Tablice idą od najmniejszej liczby figur (a przy tej samej - od najmniejszej liczby pionów),
+// więc każde bicie i promocja prowadzi do tablicy, która jest już na dysku i jest czytana przez mmap.
+// W pamięci jest tylko liczona właśnie para tablic: materiał i jego odbicie kolorów
+// (ruch białych w jednej to pozycja z czarnymi na ruchu w drugiej). Wewnątrz pary pozycje łączą
+// tylko ruchy ciche bez promocji, więc od pozycji rozstrzygniętych idziemy wstecz po cofniętych ruchach:
+// poprzednik przegranej jest wygrany, a poprzednik, któremu wszystkie ruchy dają wygraną przeciwnikowi, przegrany.
+// Pozycje są rozstrzygane w kolejności dystansu (kubełki 0, 1, 2, ...), równolegle w obrębie kubełka.
+// Co zostaje nierozstrzygnięte, to remis (obie strony mogą grać bez końca).
+//
+// Para tablic nie jest dzielona na części: cztery bajty na pozycję i kubełki z indeksami to w praktyce około
+// 9 bajtów na pozycję pary. Przy 6 figurach największa para (tb_1122 + tb_2211, 2.3e8 pozycji) to około 2 GB,
+// a przy 7 już 3e9 pozycji (ok. 26 GB), więc generator kończy na MAX_GENERATED_PIECES. Tablebase czyta
+// tablice do tb::MAX_PIECES, gdyby powstały inaczej.
+//
+// tbgen [max figur, do 6] [katalog] [wątki]
+
+namespace {
+    using Bytes = std::unique_ptr<std::atomic<uint8_t>[]>;
+
+    constexpr int MAX_GENERATED_PIECES = 6; // największa para tablic mieści się w ok. 2 GB RAM
+    static_assert(MAX_GENERATED_PIECES <= tb::MAX_PIECES, "indeks tablic liczy do tb::MAX_PIECES figur");
+
+    constexpr uint8_t NONE = 0xFF;    // winIn: brak ruchu do przegranej przeciwnika
+    constexpr uint8_t BLOCKED = 0xFF; // pending: jakiś ruch prowadzi do remisu, więc pozycja nie może być przegrana
+
+    struct Table {
+        tb::Material material;
+        uint64_t size = 0;
+        Bytes value;   // wynik jak w pliku (0 = jeszcze nie rozstrzygnięta)
+        Bytes winIn;   // najkrótsza znana wygrana (NONE = brak)
+        Bytes lossIn;  // najdłuższa znana przegrana, gdy wszystkie ruchy prowadzą do wygranej przeciwnika
+        Bytes pending; // ruchy ciche, których wynik jeszcze nie jest znany
+        std::vector<std::vector<uint64_t>> buckets; // pozycje do sprawdzenia przy danym dystansie
+
+        Table(const tb::Material& m) : material(m), size(tb::tableSize(m)), buckets(tb::MAX_DISTANCE + 1) {
+            for (Bytes* b : { &value, &winIn, &lossIn, &pending })
+                b->reset(new std::atomic<uint8_t>[size]);
+        }
+    };
+
+    uint8_t get(const Bytes& b, uint64_t i) { return b[i].load(std::memory_order_relaxed); }
+    void set(const Bytes& b, uint64_t i, uint8_t v) { b[i].store(v, std::memory_order_relaxed); }
+
+    class Generator {
+    public:
+        Generator(const Tablebase& done, int threads) : done(done), threads(threads) {}
+
+        // Liczy materiał m (i jego odbicie, jeśli jest inne) i zapisuje pliki do dir
+        bool run(const tb::Material& m, const std::string& dir);
+
+    private:
+        const Tablebase& done;
+        int threads;
+        std::vector<std::unique_ptr<Table>> tables;
+        std::mutex bucketMutex;
+
+        Table& other(const Table& t) { return *tables[tables.size() == 2 && &t == tables[0].get() ? 1 : 0]; }
+
+        // Pozycja po ruchu do innej tablicy (bicie, promocja) - wynik dla strony, która jest teraz na ruchu
+        Tablebase::Entry lookup(const Position& afterMove) const;
+        void init(Table& t);
+        void resolve(Table& t, int level);
+        template <typename Work> void parallel(uint64_t size, Work work);
+        bool write(const Table& t, const std::string& dir) const;
+    };
+
+    template <typename Work>
+    void Generator::parallel(uint64_t size, Work work) {
+        constexpr uint64_t CHUNK = 1 << 12;
+        std::atomic<uint64_t> next{ 0 };
+        auto loop = [&]() {
+            for (;;) {
+                uint64_t begin = next.fetch_add(CHUNK);
+                if (begin >= size) break;
+                work(begin, std::min(size, begin + CHUNK));
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int i = 1; i < threads; ++i)
+            pool.emplace_back(loop);
+        loop();
+        for (auto& t : pool)
+            t.join();
+    }
+
+    Tablebase::Entry Generator::lookup(const Position& afterMove) const {
+        Position q = tb::flip(afterMove);
+        Tablebase::Entry e;
+        if (!q.white) {
+            e.result = Tablebase::Result::Loss; // wszystkie figury zbite
+            return e;
+        }
+        if (!done.probe(q, true, e)) {
+            std::cerr << "missing table " << tb::materialOf(q).fileName() << "\n";
+            std::exit(1);
+        }
+        return e;
+    }
+
+    // Ruchy do innych tablic mają już wynik; ruchy ciche tylko liczymy - rozstrzygnie je przejście wstecz
+    void Generator::init(Table& t) {
+        std::vector<std::vector<uint64_t>> found(tb::MAX_DISTANCE + 1);
+
+        parallel(t.size, [&](uint64_t begin, uint64_t end) {
+            std::vector<std::vector<uint64_t>> local(tb::MAX_DISTANCE + 1);
+            GameState state;
+            for (uint64_t i = begin; i < end; ++i) {
+                set(t.value, i, 0);
+                set(t.winIn, i, NONE);
+                set(t.lossIn, i, 0);
+                set(t.pending, i, 0);
+                if (!tb::unindex(t.material, i, state.pos))
+                    continue;
+
+                MoveList moves;
+                state.generateMoves(true, moves);
+                if (moves.empty()) {
+                    local[0].push_back(i); // przegrana w 0
+                    continue;
+                }
+
+                int quiet = 0, winIn = NONE, lossIn = 0;
+                bool drawn = false;
+                for (Move move : moves) {
+                    if (!move.isCapture() && !move.promotes()) {
+                        ++quiet;
+                        continue;
+                    }
+                    GameState::MoveBackup backup = state.applyMove(move, true);
+                    Tablebase::Entry e = lookup(state.pos);
+                    state.undoMove(backup);
+
+                    if (e.result == Tablebase::Result::Loss)
+                        winIn = std::min(winIn, e.distance + 1);
+                    else if (e.result == Tablebase::Result::Win)
+                        lossIn = std::max(lossIn, e.distance + 1);
+                    else
+                        drawn = true;
+                }
+
+                set(t.pending, i, drawn ? BLOCKED : uint8_t(quiet));
+                set(t.lossIn, i, uint8_t(std::min(lossIn, int(tb::MAX_DISTANCE))));
+                if (winIn <= tb::MAX_DISTANCE) {
+                    set(t.winIn, i, uint8_t(winIn));
+                    local[winIn].push_back(i);
+                }
+                else if (!drawn && quiet == 0 && lossIn <= tb::MAX_DISTANCE)
+                    local[lossIn].push_back(i);
+            }
+
+            std::lock_guard<std::mutex> lock(bucketMutex);
+            for (int d = 0; d <= tb::MAX_DISTANCE; ++d)
+                found[d].insert(found[d].end(), local[d].begin(), local[d].end());
+        });
+
+        for (int d = 0; d <= tb::MAX_DISTANCE; ++d)
+            t.buckets[d] = std::move(found[d]);
+    }
+
+    // Rozstrzyga pozycje z kubełka level i przekazuje wynik poprzednikom w drugiej tablicy pary
+    void Generator::resolve(Table& t, int level) {
+        std::vector<uint64_t> bucket = std::move(t.buckets[level]);
+        t.buckets[level].clear();
+        Table& prev = other(t);
+
+        parallel(bucket.size(), [&](uint64_t begin, uint64_t end) {
+            std::vector<std::pair<int, uint64_t>> pushed; // (dystans, indeks w prev)
+            for (uint64_t k = begin; k < end; ++k) {
+                uint64_t i = bucket[k];
+                if (get(t.value, i) != 0)
+                    continue;
+
+                // Wpis mógł się zdezaktualizować - sprawdzamy, czy pozycja naprawdę kończy się w level
+                bool win;
+                uint8_t winIn = get(t.winIn, i);
+                if (winIn != NONE) {
+                    if (winIn != level) continue;
+                    win = true;
+                }
+                else if (get(t.pending, i) == 0 && get(t.lossIn, i) == level) {
+                    win = false;
+                }
+                else
+                    continue;
+                set(t.value, i, uint8_t(level + 1));
+
+                if (level + 1 > tb::MAX_DISTANCE)
+                    continue;
+
+                // Poprzedniki: białe w prev cofają ruch cichy, po którym (po odbiciu) powstaje ta pozycja
+                Position after;
+                tb::unindex(t.material, i, after);
+                after = tb::flip(after); // białe właśnie się ruszyły, czarne na ruchu
+
+                Bitboard pieces = after.white;
+                while (pieces) {
+                    int sq = bb::popLsb(pieces);
+                    bool king = (after.kings & bb::bit(sq)) != 0;
+                    for (int d = 0; d < 4; ++d) {
+                        if (!king && !bb::isForward(d, true)) continue;
+                        Bitboard origin = bb::shift(bb::bit(sq), bb::opposite(d)) & after.empty();
+                        if (!origin) continue;
+                        if (!king && (origin & bb::ROW_0)) continue; // pion nie mógł stać na polu promocji
+
+                        GameState before;
+                        before.pos = after;
+                        before.pos.white ^= bb::bit(sq) | origin;
+                        if (king) before.pos.kings ^= bb::bit(sq) | origin;
+                        if (before.hasCapture(true)) continue; // ruch cichy byłby nielegalny
+
+                        uint64_t p = tb::index(prev.material, before.pos);
+                        if (get(prev.value, p) != 0) continue;
+
+                        if (!win) {
+                            // ruch do przegranej przeciwnika: wygrana w level + 1, o ile nie ma szybszej
+                            uint8_t current = get(prev.winIn, p);
+                            while (current > level + 1 && !prev.winIn[p].compare_exchange_weak(current, uint8_t(level + 1))) {}
+                            if (current > level + 1)
+                                pushed.push_back({ level + 1, p });
+                        }
+                        else {
+                            // kolejny ruch do wygranej przeciwnika; ostatni rozstrzyga przegraną
+                            uint8_t longest = get(prev.lossIn, p);
+                            while (longest < level + 1 && !prev.lossIn[p].compare_exchange_weak(longest, uint8_t(level + 1))) {}
+                            uint8_t left = get(prev.pending, p);
+                            if (left == BLOCKED) continue;
+                            if (prev.pending[p].fetch_sub(1) == 1)
+                                pushed.push_back({ get(prev.lossIn, p), p });
+                        }
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(bucketMutex);
+            for (auto [d, p] : pushed)
+                prev.buckets[d].push_back(p);
+        });
+    }
+
+    bool Generator::write(const Table& t, const std::string& dir) const {
+        // Najpierw plik tymczasowy - przerwany generator nie zostawi uciętej tablicy pod właściwą nazwą
+        std::string path = dir + "/" + t.material.fileName();
+        std::string tmp = path + ".tmp";
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out) return false;
+
+        uint8_t header[tb::HEADER_SIZE] = { 'W', 'T', 'B', '1',
+            uint8_t(t.material.whiteMen), uint8_t(t.material.whiteKings), uint8_t(t.material.blackMen), uint8_t(t.material.blackKings) };
+        for (int i = 0; i < 8; ++i)
+            header[8 + i] = uint8_t(t.size >> (8 * i));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        std::vector<char> buffer(1 << 20);
+        for (uint64_t begin = 0; begin < t.size; begin += buffer.size()) {
+            size_t count = size_t(std::min<uint64_t>(buffer.size(), t.size - begin));
+            for (size_t i = 0; i < count; ++i)
+                buffer[i] = char(get(t.value, begin + i));
+            out.write(buffer.data(), count);
+        }
+        out.close();
+        if (!out) return false;
+
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        return !ec;
+    }
+
+    bool Generator::run(const tb::Material& m, const std::string& dir) {
+        tables.clear();
+        tables.push_back(std::make_unique<Table>(m));
+        if (m != m.flipped())
+            tables.push_back(std::make_unique<Table>(m.flipped()));
+
+        for (auto& t : tables)
+            init(*t);
+
+        for (int level = 0; level <= tb::MAX_DISTANCE; ++level)
+            for (auto& t : tables)
+                resolve(*t, level);
+
+        for (const auto& t : tables) {
+            uint64_t wins = 0, losses = 0, draws = 0;
+            int longest = 0;
+            for (uint64_t i = 0; i < t->size; ++i) {
+                Tablebase::Entry e = Tablebase::decode(get(t->value, i));
+                if (e.result == Tablebase::Result::Win) ++wins;
+                else if (e.result == Tablebase::Result::Loss) ++losses;
+                else ++draws;
+                longest = std::max(longest, e.distance);
+            }
+            std::cout << "  " << t->material.fileName() << ": " << t->size << " positions, " << wins << " won, "
+                << losses << " lost, " << draws << " drawn or impossible, longest " << longest << " plies\n";
+
+            if (!write(*t, dir)) {
+                std::cerr << "cannot write " << t->material.fileName() << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+
+    int maxPieces = 4;
+    std::string dir = "tablebases";
+    int threads = std::max(1, int(std::thread::hardware_concurrency()));
+
+    if (argc > 1) maxPieces = std::stoi(argv[1]);
+    if (argc > 2) dir = argv[2];
+    if (argc > 3) threads = std::max(1, std::stoi(argv[3]));
+
+    if (maxPieces < 2 || maxPieces > MAX_GENERATED_PIECES) {
+        std::cerr << "tbgen generates tables of 2.." << MAX_GENERATED_PIECES << " pieces (the whole pair is kept in RAM)\n";
+        return 1;
+    }
+
+    std::filesystem::create_directories(dir);
+
+    // Kolejność: liczba figur, potem liczba pionów (promocja zamienia pion w damkę)
+    std::vector<tb::Material> order;
+    for (int total = 2; total <= maxPieces; ++total)
+        for (int wm = 0; wm <= total; ++wm)
+            for (int wk = 0; wm + wk <= total; ++wk)
+                for (int bm = 0; wm + wk + bm <= total; ++bm) {
+                    int bk = total - wm - wk - bm;
+                    if (wm + wk > 0 && bm + bk > 0)
+                        order.push_back({ wm, wk, bm, bk });
+                }
+    std::stable_sort(order.begin(), order.end(), [](const tb::Material& a, const tb::Material& b) {
+        if (a.total() != b.total()) return a.total() < b.total();
+        return a.whiteMen + a.blackMen < b.whiteMen + b.blackMen;
+    });
+
+    Tablebase done;
+    done.load(dir); // wznowienie: gotowe tablice nie są liczone drugi raz
+    Generator generator(done, threads);
+
+    std::cout << "Tablebases up to " << maxPieces << " pieces in " << dir << ", " << threads << " threads\n";
+    Clock::time_point start = Clock::now();
+
+    for (const tb::Material& m : order) {
+        std::string path = dir + "/" + m.fileName();
+        std::string flippedPath = dir + "/" + m.flipped().fileName();
+        if (std::filesystem::exists(path) && std::filesystem::exists(flippedPath))
+            continue;
+
+        Clock::time_point t0 = Clock::now();
+        std::cout << m.fileName() << (m != m.flipped() ? " + " + m.flipped().fileName() : std::string()) << "\n";
+        if (!generator.run(m, dir))
+            return 1;
+        done.add(path);
+        if (m != m.flipped())
+            done.add(flippedPath);
+        std::cout << "  " << std::fixed << std::setprecision(2)
+            << std::chrono::duration<double>(Clock::now() - t0).count() << " s\n";
+    }
+
+    std::cout << "done in " << std::fixed << std::setprecision(1)
+        << std::chrono::duration<double>(Clock::now() - start).count() << " s\n";
+    return 0;
+}
@@ -0,0 +1,333 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include "../Search.hpp"
+#include "../Notation.hpp"
+#include "../Scenarios.hpp"
+
+// Turniej bez okna: silnik A kontra silnik B, partie równolegle (jedna partia na wątek naraz).
+// Każde losowe otwarcie gra się dwa razy, z zamianą kolorów. Wyniki idą linia po linii do pliku,
+// a SPRT przerywa turniej, gdy tylko wiadomo, czy A jest mocniejszy o elo1, czy nie lepszy niż elo0.
+//
+// tournament [--a SPEC] [--b SPEC] [--games N] [--threads N] [--hash MB] [--out PLIK]
+//            [--opening-plies N] [--max-plies N] [--seed N] [--elo0 E] [--elo1 E] [--alpha A] [--beta B] [--no-sprt]
+//
+// SPEC to lista po przecinku: depth=N, time=MS (zamiast głębokości), eval=standard|material|handcrafted,
+// qsearch|pvs|aspiration|lmr=on|off, np. --a depth=6 --b depth=6,eval=material
+
+namespace {
+    struct EngineConfig {
+        int depth = 6;
+        int timeMs = 0;
+        EvalVariant eval = EvalVariant::Standard;
+        bool quiescence = true;
+        bool pvs = true;
+        bool aspiration = true;
+        bool lmr = true;
+        std::string text = "depth=6";
+    };
+
+    struct Options {
+        EngineConfig a, b;
+        int games = 10000;
+        int threads = std::max(1, int(std::thread::hardware_concurrency()));
+        int hashMB = 8;
+        std::string out = "tournament.txt";
+        int openingPlies = 6;
+        int maxPlies = 300;
+        uint64_t seed = 1;
+        bool sprt = true;
+        double elo0 = 0, elo1 = 10, alpha = 0.05, beta = 0.05;
+    };
+
+    bool parseEngine(const std::string& spec, EngineConfig& config) {
+        config = EngineConfig();
+        config.text = spec;
+        std::stringstream ss(spec);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            size_t eq = item.find('=');
+            if (eq == std::string::npos) return false;
+            std::string key = item.substr(0, eq), value = item.substr(eq + 1);
+            try {
+                if (key == "depth") config.depth = std::clamp(std::stoi(value), 1, MAX_SEARCH_DEPTH);
+                else if (key == "time") config.timeMs = std::max(1, std::stoi(value));
+                else if (key == "eval" && value == "standard") config.eval = EvalVariant::Standard;
+                else if (key == "eval" && value == "material") config.eval = EvalVariant::MaterialOnly;
+                else if (key == "eval" && value == "handcrafted") config.eval = EvalVariant::Handcrafted;
+                else if (value != "on" && value != "off") return false;
+                else if (key == "qsearch") config.quiescence = value == "on";
+                else if (key == "pvs") config.pvs = value == "on";
+                else if (key == "aspiration") config.aspiration = value == "on";
+                else if (key == "lmr") config.lmr = value == "on";
+                else return false;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        }
+        if (config.timeMs > 0) config.depth = MAX_SEARCH_DEPTH;
+        return true;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& o) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--no-sprt") { o.sprt = false; continue; }
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            try {
+                if (arg == "--a") { if (!parseEngine(value, o.a)) return false; }
+                else if (arg == "--b") { if (!parseEngine(value, o.b)) return false; }
+                else if (arg == "--games") o.games = std::max(2, std::stoi(value));
+                else if (arg == "--threads") o.threads = std::max(1, std::stoi(value));
+                else if (arg == "--hash") o.hashMB = std::max(0, std::stoi(value));
+                else if (arg == "--out") o.out = value;
+                else if (arg == "--opening-plies") o.openingPlies = std::max(0, std::stoi(value));
+                else if (arg == "--max-plies") o.maxPlies = std::max(1, std::stoi(value));
+                else if (arg == "--seed") o.seed = std::stoull(value);
+                else if (arg == "--elo0") o.elo0 = std::stod(value);
+                else if (arg == "--elo1") o.elo1 = std::stod(value);
+                else if (arg == "--alpha") o.alpha = std::stod(value);
+                else if (arg == "--beta") o.beta = std::stod(value);
+                else return false;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Losowe otwarcie dla pary partii: te same ruchy dla obu kolorów, powtarzalne dla danego ziarna
+    std::vector<Move> randomOpening(uint64_t seed, int pair, int plies) {
+        std::mt19937_64 rng(seed * 0x9E3779B97F4A7C15ull + uint64_t(pair));
+        for (;;) {
+            GameState state;
+            scenario::startPosition(state);
+            bool whiteTurn = true;
+            std::vector<Move> line;
+            for (int i = 0; i < plies; ++i) {
+                MoveList moves;
+                state.generateMoves(whiteTurn, moves);
+                if (moves.empty()) break;
+                Move m = moves[int(rng() % uint64_t(moves.size()))];
+                line.push_back(m);
+                state.applyMove(m, whiteTurn);
+                whiteTurn = !whiteTurn;
+            }
+            if (int(line.size()) == plies && state.hasMoves(whiteTurn))
+                return line;
+        }
+    }
+
+    enum class Outcome { WhiteWins, BlackWins, Draw };
+
+    struct GameRecord {
+        Outcome outcome = Outcome::Draw;
+        std::string reason;
+        std::string moves;
+        int plies = 0;
+    };
+
+    // Partia do końca: brak ruchu = przegrana, trzykrotne powtórzenie albo limit półruchów = remis
+    GameRecord playGame(Search& white, const EngineConfig& whiteConfig, Search& black, const EngineConfig& blackConfig,
+                        const std::vector<Move>& opening, int maxPlies) {
+        GameRecord record;
+        GameState state;
+        scenario::startPosition(state);
+        bool whiteTurn = true;
+        std::vector<uint64_t> history{ state.key(whiteTurn) };
+
+        auto play = [&](Move m) {
+            if (!record.moves.empty()) record.moves += ' ';
+            record.moves += notation::moveToString(state, whiteTurn, m);
+            state.applyMove(m, whiteTurn);
+            whiteTurn = !whiteTurn;
+            history.push_back(state.key(whiteTurn));
+            ++record.plies;
+        };
+
+        for (Move m : opening)
+            play(m);
+
+        for (;;) {
+            if (!state.hasMoves(whiteTurn)) {
+                record.outcome = whiteTurn ? Outcome::BlackWins : Outcome::WhiteWins;
+                record.reason = "no moves";
+                return record;
+            }
+            if (std::count(history.begin(), history.end(), history.back()) >= 3) {
+                record.reason = "repetition";
+                return record;
+            }
+            if (record.plies >= maxPlies) {
+                record.reason = "ply limit";
+                return record;
+            }
+
+            Search& search = whiteTurn ? white : black;
+            const EngineConfig& config = whiteTurn ? whiteConfig : blackConfig;
+            SearchResult result = search.run(state, whiteTurn, config.depth, config.timeMs);
+            play(result.move);
+        }
+    }
+
+    // Wynik z punktu widzenia A; SPRT na przybliżeniu normalnym (jak w fishtest, model trójmianowy)
+    struct Score {
+        int wins = 0, draws = 0, losses = 0;
+
+        int games() const { return wins + draws + losses; }
+        double mean() const { return games() ? (wins + 0.5 * draws) / games() : 0.5; }
+
+        // Wariancja wyniku partii z dodaną jedną udawaną wygraną, remisem i przegraną. Przy samych remisach
+        // albo samych wygranych (częste między deterministycznymi silnikami) zwykła wariancja to 0,
+        // a wtedy LLR stoi w miejscu i SPRT nie kończy się przed --games.
+        double variance() const {
+            double w = wins + 1, d = draws + 1, l = losses + 1, n = w + d + l;
+            double s = (w + 0.5 * d) / n;
+            return (w * (1 - s) * (1 - s) + d * (0.5 - s) * (0.5 - s) + l * s * s) / n;
+        }
+
+        static double expected(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+        static double elo(double score) { return -400.0 * std::log10(1.0 / score - 1.0); }
+
+        double llr(double elo0, double elo1) const {
+            if (games() == 0) return 0;
+            double var = variance();
+            double s0 = expected(elo0), s1 = expected(elo1);
+            return games() * (s1 - s0) * (2 * mean() - s0 - s1) / (2 * var);
+        }
+
+        // Elo A - B i połowa szerokości przedziału 95%
+        void eloEstimate(double& elo, double& margin) const {
+            double s = std::clamp(mean(), 1e-3, 1 - 1e-3);
+            double sd = games() ? std::sqrt(variance() / games()) : 0;
+            elo = Score::elo(s);
+            margin = (Score::elo(std::min(s + 1.96 * sd, 1 - 1e-3)) - Score::elo(std::max(s - 1.96 * sd, 1e-3))) / 2;
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        std::cerr << "usage: tournament [--a SPEC] [--b SPEC] [--games N] [--threads N] [--hash MB] [--out FILE]\n"
+                     "                  [--opening-plies N] [--max-plies N] [--seed N] [--elo0 E] [--elo1 E]\n"
+                     "                  [--alpha A] [--beta B] [--no-sprt]\n"
+                     "SPEC: depth=N,time=MS,eval=standard|material|handcrafted,qsearch|pvs|aspiration|lmr=on|off\n";
+        return 1;
+    }
+
+    std::ofstream out(o.out);
+    if (!out) {
+        std::cerr << "cannot write " << o.out << "\n";
+        return 1;
+    }
+
+    const double lower = std::log(o.beta / (1 - o.alpha));
+    const double upper = std::log((1 - o.beta) / o.alpha);
+
+    std::cout << "A: " << o.a.text << "  B: " << o.b.text << "  games " << o.games << ", " << o.threads
+        << " threads, results in " << o.out << "\n";
+    if (o.sprt)
+        std::cout << "SPRT elo0 " << o.elo0 << " elo1 " << o.elo1 << ", LLR bounds [" << std::setprecision(3)
+            << lower << ", " << upper << "]\n";
+
+    std::mutex resultMutex;
+    Score score;
+    std::atomic<int> nextGame{ 0 };
+    std::atomic<bool> finished{ false };
+    std::string verdict = "game limit reached";
+    Clock::time_point start = Clock::now();
+
+    auto worker = [&]() {
+        Search a, b;
+        a.resizeTT(o.hashMB);
+        b.resizeTT(o.hashMB);
+        for (auto [search, config] : { std::make_pair(&a, &o.a), std::make_pair(&b, &o.b) }) {
+            search->setEvalVariant(config->eval);
+            search->setQuiescence(config->quiescence);
+            search->setPvs(config->pvs);
+            search->setAspiration(config->aspiration);
+            search->setLateMoveReductions(config->lmr);
+        }
+
+        for (;;) {
+            int game = nextGame++;
+            if (game >= o.games || finished) break;
+
+            // Partie 2k i 2k+1 mają to samo otwarcie; w parzystej A gra białymi
+            int pair = game / 2;
+            bool aWhite = game % 2 == 0;
+            std::vector<Move> opening = randomOpening(o.seed, pair, o.openingPlies);
+
+            a.clearTT();
+            b.clearTT();
+            GameRecord record = aWhite ? playGame(a, o.a, b, o.b, opening, o.maxPlies)
+                                       : playGame(b, o.b, a, o.a, opening, o.maxPlies);
+
+            const char* result = record.outcome == Outcome::WhiteWins ? "1-0" : record.outcome == Outcome::BlackWins ? "0-1" : "1/2-1/2";
+            bool aWon = (record.outcome == Outcome::WhiteWins) == aWhite && record.outcome != Outcome::Draw;
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (finished) break; // wynik po decyzji SPRT już się nie liczy
+
+            if (record.outcome == Outcome::Draw) ++score.draws;
+            else if (aWon) ++score.wins;
+            else ++score.losses;
+
+            out << "game " << game << " white " << (aWhite ? "A" : "B") << " black " << (aWhite ? "B" : "A")
+                << " result " << result << " (" << record.reason << ") plies " << record.plies
+                << " moves " << record.moves << "\n";
+            out.flush();
+
+            double llr = score.llr(o.elo0, o.elo1);
+            if (score.games() % 100 == 0) {
+                double elo, margin;
+                score.eloEstimate(elo, margin);
+                std::cout << "games " << score.games() << "  +" << score.wins << " =" << score.draws << " -" << score.losses
+                    << "  elo " << std::fixed << std::setprecision(1) << elo << " +/- " << margin;
+                if (o.sprt) std::cout << "  LLR " << std::setprecision(2) << llr;
+                std::cout << std::defaultfloat << "\n";
+            }
+
+            if (o.sprt && (llr >= upper || llr <= lower)) {
+                verdict = llr >= upper ? "SPRT: H1 accepted (A is stronger)" : "SPRT: H0 accepted (A is not stronger)";
+                finished = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < o.threads; ++i)
+        threads.emplace_back(worker);
+    for (auto& t : threads)
+        t.join();
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    double elo, margin;
+    score.eloEstimate(elo, margin);
+
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(1) << "A vs B: +" << score.wins << " =" << score.draws << " -" << score.losses
+        << " (" << score.games() << " games, " << 100 * score.mean() << "%), elo " << elo << " +/- " << margin;
+    if (o.sprt)
+        summary << ", LLR " << std::setprecision(2) << score.llr(o.elo0, o.elo1);
+    summary << std::setprecision(1) << ", " << seconds << " s, " << score.games() / std::max(seconds, 1e-9) << " games/s";
+
+    std::cout << verdict << "\n" << summary.str() << "\n";
+    out << "# " << verdict << "\n# " << summary.str() << "\n";
+    return 0;
+}
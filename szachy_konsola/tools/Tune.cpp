@@ -0,0 +1,421 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include "../GameState.hpp"
+#include "../Notation.hpp"
+#include "../Scenarios.hpp"
+#include "../MappedFile.hpp"
+
+// Strojenie wag oceny metodą Texela.
+// extract: z wyników turnieju (tools/Tournament.cpp, linie "game ... result R (...) plies P moves ...")
+//   bierze spokojne pozycje - strona na ruchu nie ma bicia, więc ocenia je stand-pat w quiescence -
+//   i zapisuje je z wynikiem partii do zwartego pliku binarnego.
+// fit: mapuje plik, liczy cechy eval::extract dla wszystkich pozycji (kolumny cech, wiele wątków),
+//   na przemian dobiera stałą K sigmoidy i minimalizuje błąd średniokwadratowy między sigmoidą oceny
+//   a wynikiem partii (Adam na pełnym gradiencie), potem zapisuje nowy EvalWeights.hpp.
+//   MAN zostaje 100 (skala oceny), a pozostałe wagi po każdym kroku wracają do przedziałów BOUNDS.
+//
+// tune extract [--skip N] [--out PLIK] LOG...
+// tune fit [--data PLIK] [--out PLIK] [--threads N] [--iterations N] [--rate R] [--source OPIS]
+//   (OPIS - skąd są dane, np. jakie partie; trafia do notki w EvalWeights.hpp)
+//
+// Plik: "WTD1", 4 bajty zarezerwowane, liczba pozycji (u64), potem rekordy po 16 bajtów:
+// białe, czarne, damki (u32), strona na ruchu (1 = białe), wynik (0 = wygrały czarne, 1 = remis, 2 = białe), 2 bajty 0.
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Granice wag przy dopasowaniu. Same dane z samogry dają też wagi bez sensu (damka tańsza od piona,
+    // kara za marsz do promocji), a takiej oceny przeszukiwanie nie powinno dostać: damka ma być warta
+    // więcej niż pion, zagrożenie to kara, cechy pozycyjne to premie. Waga na granicy jest wypisywana.
+    struct Bound {
+        double lo, hi;
+    };
+    constexpr Bound BOUNDS[eval::FEATURES] = {
+        { 100, 100 }, // MAN - skala, nie stroimy
+        { 125, 300 }, // KING
+        { -150, 0 },  // THREAT
+        { 0, 50 },    // ADVANCED
+        { 0, 50 },    // BACK_RANK
+        { 0, 50 },    // CENTER
+    };
+
+    constexpr size_t HEADER_SIZE = 16;
+    constexpr size_t RECORD_SIZE = 16;
+
+    double seconds(Clock::time_point since) {
+        return std::chrono::duration<double>(Clock::now() - since).count();
+    }
+
+    void writeLe(uint8_t* p, uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i)
+            p[i] = uint8_t(v >> (8 * i));
+    }
+
+    uint64_t readLe(const uint8_t* p, int bytes) {
+        uint64_t v = 0;
+        for (int i = bytes - 1; i >= 0; --i)
+            v = v << 8 | p[i];
+        return v;
+    }
+
+    // ---- extract ----
+
+    // Jedna linia logu: false, jeśli to nie partia albo ruch się nie zgadza
+    bool extractGame(const std::string& line, int skip, std::vector<uint8_t>& out, uint64_t& count) {
+        if (line.rfind("game ", 0) != 0)
+            return false;
+        size_t r = line.find(" result "), m = line.find(" moves ");
+        if (r == std::string::npos)
+            return false;
+
+        std::string result = line.substr(r + 8, line.find(' ', r + 8) - r - 8);
+        uint8_t label = result == "1-0" ? 2 : result == "0-1" ? 0 : 1;
+
+        GameState state;
+        scenario::startPosition(state);
+        bool whiteTurn = true;
+
+        std::istringstream moves(m == std::string::npos ? std::string() : line.substr(m + 7));
+        std::string text;
+        for (int ply = 0; moves >> text; ++ply) {
+            if (ply >= skip && !state.hasCapture(whiteTurn)) {
+                uint8_t record[RECORD_SIZE] = {};
+                writeLe(record, state.pos.white, 4);
+                writeLe(record + 4, state.pos.black, 4);
+                writeLe(record + 8, state.pos.kings, 4);
+                record[12] = whiteTurn ? 1 : 0;
+                record[13] = label;
+                out.insert(out.end(), record, record + RECORD_SIZE);
+                ++count;
+            }
+
+            Move move = notation::parseMove(state, whiteTurn, text);
+            if (move.isNull())
+                return false;
+            state.applyMove(move, whiteTurn);
+            whiteTurn = !whiteTurn;
+        }
+        return true;
+    }
+
+    int runExtract(int argc, char** argv) {
+        int skip = 6;
+        std::string outPath = "positions.bin";
+        std::vector<std::string> logs;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--skip" && i + 1 < argc) skip = std::max(0, std::atoi(argv[++i]));
+            else if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+            else logs.push_back(arg);
+        }
+        if (logs.empty()) {
+            std::cerr << "usage: tune extract [--skip N] [--out FILE] LOG...\n";
+            return 1;
+        }
+
+        Clock::time_point start = Clock::now();
+        std::vector<uint8_t> data(HEADER_SIZE, 0);
+        uint64_t count = 0, games = 0, bad = 0;
+        for (const std::string& path : logs) {
+            std::ifstream in(path);
+            if (!in) {
+                std::cerr << "cannot read " << path << "\n";
+                return 1;
+            }
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.rfind("game ", 0) != 0)
+                    continue;
+                size_t before = data.size();
+                uint64_t countBefore = count;
+                if (extractGame(line, skip, data, count)) {
+                    ++games;
+                }
+                else {
+                    data.resize(before); // partia z błędnym ruchem - nic z niej nie bierzemy
+                    count = countBefore;
+                    ++bad;
+                }
+            }
+        }
+
+        std::memcpy(data.data(), "WTD1", 4);
+        writeLe(data.data() + 8, count, 8);
+        std::ofstream out(outPath, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+        if (!out) {
+            std::cerr << "cannot write " << outPath << "\n";
+            return 1;
+        }
+
+        std::cout << games << " games (" << bad << " skipped), " << count << " quiet positions -> " << outPath
+            << " in " << std::fixed << std::setprecision(2) << seconds(start) << " s\n";
+        return 0;
+    }
+
+    // ---- fit ----
+
+    // Pozycje jako kolumny: cecha f pozycji i to columns[f][i]. Pętle idą po i, więc kompilator je wektoryzuje.
+    struct Dataset {
+        size_t size = 0;
+        std::vector<float> columns[eval::FEATURES];
+        std::vector<float> result; // 0, 0.5, 1 z punktu widzenia białych
+    };
+
+    template <typename Work>
+    void parallel(size_t size, int threads, Work work) {
+        std::vector<std::thread> pool;
+        size_t chunk = (size + threads - 1) / threads;
+        for (int t = 0; t < threads; ++t) {
+            size_t begin = std::min(size, t * chunk), end = std::min(size, begin + chunk);
+            pool.emplace_back([&work, t, begin, end] { work(t, begin, end); });
+        }
+        for (std::thread& th : pool)
+            th.join();
+    }
+
+    bool loadDataset(const std::string& path, int threads, Dataset& d) {
+        MappedFile file;
+        if (!file.open(path) || file.size() < HEADER_SIZE || std::memcmp(file.data(), "WTD1", 4) != 0)
+            return false;
+        uint64_t count = readLe(file.data() + 8, 8);
+        if (file.size() != HEADER_SIZE + count * RECORD_SIZE)
+            return false;
+
+        d.size = size_t(count);
+        for (auto& c : d.columns)
+            c.resize(d.size);
+        d.result.resize(d.size);
+
+        const uint8_t* records = file.data() + HEADER_SIZE;
+        parallel(d.size, threads, [&](int, size_t begin, size_t end) {
+            constexpr size_t BATCH = 256;
+            Bitboard white[BATCH], black[BATCH], kings[BATCH];
+            int16_t features[BATCH][eval::FEATURES];
+
+            for (size_t base = begin; base < end; base += BATCH) {
+                size_t n = std::min(BATCH, end - base);
+                // Najpierw rozpakowanie rekordów, potem cechy w osobnej pętli bez rozgałęzień
+                for (size_t i = 0; i < n; ++i) {
+                    const uint8_t* r = records + (base + i) * RECORD_SIZE;
+                    white[i] = Bitboard(readLe(r, 4));
+                    black[i] = Bitboard(readLe(r + 4, 4));
+                    kings[i] = Bitboard(readLe(r + 8, 4));
+                    d.result[base + i] = 0.5f * r[13];
+                }
+                for (size_t i = 0; i < n; ++i)
+                    eval::extract(white[i], black[i], kings[i], features[i]);
+                for (int f = 0; f < eval::FEATURES; ++f)
+                    for (size_t i = 0; i < n; ++i)
+                        d.columns[f][base + i] = features[i][f];
+            }
+        });
+        return true;
+    }
+
+    // Błąd i gradient dla wag w; used = cechy, które wchodzą do oceny
+    struct Evaluator {
+        const Dataset& d;
+        int threads;
+        std::vector<float> score; // bufor ocen, żeby nie alokować w każdej iteracji
+
+        Evaluator(const Dataset& d, int threads) : d(d), threads(threads), score(d.size) {}
+
+        double run(const double* w, const bool* used, double k, double* gradient) {
+            std::vector<double> errors(threads, 0.0);
+            std::vector<std::vector<double>> grads(threads, std::vector<double>(eval::FEATURES, 0.0));
+            const double scale = k * std::log(10.0) / 400.0;
+
+            parallel(d.size, threads, [&](int t, size_t begin, size_t end) {
+                float* s = score.data();
+                std::fill(s + begin, s + end, 0.0f);
+                for (int f = 0; f < eval::FEATURES; ++f) {
+                    if (!used[f]) continue;
+                    const float* col = d.columns[f].data();
+                    const float wf = float(w[f]);
+                    for (size_t i = begin; i < end; ++i)
+                        s[i] += wf * col[i];
+                }
+
+                double err = 0;
+                double* g = grads[t].data();
+                for (size_t i = begin; i < end; ++i) {
+                    double p = 1.0 / (1.0 + std::exp(-scale * s[i]));
+                    double diff = d.result[i] - p;
+                    err += diff * diff;
+                    s[i] = float(-2.0 * diff * scale * p * (1.0 - p)); // dE/ds, do gradientu
+                }
+                errors[t] = err;
+                if (!gradient) return;
+
+                for (int f = 0; f < eval::FEATURES; ++f) {
+                    if (!used[f]) continue;
+                    const float* col = d.columns[f].data();
+                    double sum = 0;
+                    for (size_t i = begin; i < end; ++i)
+                        sum += s[i] * col[i];
+                    g[f] = sum;
+                }
+            });
+
+            double err = 0;
+            for (double e : errors) err += e;
+            if (gradient) {
+                for (int f = 0; f < eval::FEATURES; ++f) {
+                    gradient[f] = 0;
+                    for (const auto& g : grads) gradient[f] += g[f];
+                    gradient[f] /= double(d.size);
+                }
+            }
+            return err / double(d.size);
+        }
+    };
+
+    void project(double* w) {
+        for (int f = 0; f < eval::FEATURES; ++f)
+            w[f] = std::clamp(w[f], BOUNDS[f].lo, BOUNDS[f].hi);
+    }
+
+    // Adam na pełnym gradiencie: ocena z cech used, zmieniane tylko cechy tuned, po każdym kroku w granicach BOUNDS
+    void optimize(Evaluator& e, double* w, const bool* used, const bool* tuned, double k, int iterations, double rate) {
+        double m[eval::FEATURES] = {}, v[eval::FEATURES] = {}, g[eval::FEATURES];
+        const double b1 = 0.9, b2 = 0.999;
+        for (int it = 1; it <= iterations; ++it) {
+            double err = e.run(w, used, k, g);
+            for (int f = 0; f < eval::FEATURES; ++f) {
+                if (!tuned[f]) continue;
+                m[f] = b1 * m[f] + (1 - b1) * g[f];
+                v[f] = b2 * v[f] + (1 - b2) * g[f] * g[f];
+                double mh = m[f] / (1 - std::pow(b1, it)), vh = v[f] / (1 - std::pow(b2, it));
+                w[f] -= rate * mh / (std::sqrt(vh) + 1e-12);
+            }
+            project(w);
+            if (it % 100 == 0 || it == iterations)
+                std::cout << "  iteration " << it << "  error " << std::setprecision(6) << err << "\n";
+        }
+    }
+
+    // Złoty podział: K, przy którym obecne wagi dają najmniejszy błąd
+    double fitK(Evaluator& e, const double* w, const bool* used) {
+        const double phi = (std::sqrt(5.0) - 1) / 2;
+        double lo = 0.05, hi = 10.0;
+        double a = hi - phi * (hi - lo), b = lo + phi * (hi - lo);
+        double ea = e.run(w, used, a, nullptr), eb = e.run(w, used, b, nullptr);
+        for (int i = 0; i < 40; ++i) {
+            if (ea < eb) { hi = b; b = a; eb = ea; a = hi - phi * (hi - lo); ea = e.run(w, used, a, nullptr); }
+            else { lo = a; a = b; ea = eb; b = lo + phi * (hi - lo); eb = e.run(w, used, b, nullptr); }
+        }
+        return (lo + hi) / 2;
+    }
+
+    bool writeHeader(const std::string& path, const int* weights, const std::string& source, const std::string& note) {
+        std::ofstream out(path, std::ios::binary);
+        out << "\xEF\xBB\xBF#pragma once\n#include \"Eval.hpp\"\n\n"
+            << "// Wygenerowane przez tools/Tune.cpp - nie edytować ręcznie, tylko przestroić: tune fit --out EvalWeights.hpp\n"
+            << (source.empty() ? "" : "// " + source + "\n")
+            << "// " << note << "\n"
+            << "constexpr int EVAL_WEIGHTS[eval::FEATURES] = {\n";
+        for (int f = 0; f < eval::FEATURES; ++f)
+            out << "    " << weights[f] << ", // " << eval::FEATURE_NAMES[f] << "\n";
+        out << "};\n";
+        return bool(out);
+    }
+
+    int runFit(int argc, char** argv) {
+        std::string dataPath = "positions.bin", outPath = "EvalWeights.hpp", source;
+        int threads = std::max(1, int(std::thread::hardware_concurrency()));
+        int iterations = 1000;
+        double rate = 1.0;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            std::string arg = argv[i], value = argv[i + 1];
+            if (arg == "--data") dataPath = value;
+            else if (arg == "--out") outPath = value;
+            else if (arg == "--threads") threads = std::max(1, std::atoi(value.c_str()));
+            else if (arg == "--iterations") iterations = std::max(1, std::atoi(value.c_str()));
+            else if (arg == "--rate") rate = std::atof(value.c_str());
+            else if (arg == "--source") source = value;
+            else {
+                std::cerr << "usage: tune fit [--data FILE] [--out FILE] [--threads N] [--iterations N] [--rate R] [--source TEXT]\n";
+                return 1;
+            }
+        }
+
+        Clock::time_point t0 = Clock::now();
+        Dataset d;
+        if (!loadDataset(dataPath, threads, d) || d.size == 0) {
+            std::cerr << "cannot read dataset " << dataPath << "\n";
+            return 1;
+        }
+        double loadTime = seconds(t0);
+        std::cout << d.size << " positions, features in " << std::fixed << std::setprecision(3) << loadTime << " s ("
+            << std::setprecision(1) << d.size / std::max(loadTime, 1e-9) / 1e6 << " M positions/s), " << threads << " threads\n";
+
+        Evaluator e(d, threads);
+        double w[eval::FEATURES];
+        for (int f = 0; f < eval::FEATURES; ++f)
+            w[f] = EVAL_WEIGHTS[f];
+        project(w);
+
+        // Dane to same spokojne pozycje, a ocena jest jedna (evaluate() to też stand-pat), więc wchodzą wszystkie cechy
+        bool all[eval::FEATURES], tuned[eval::FEATURES];
+        for (int f = 0; f < eval::FEATURES; ++f) {
+            all[f] = true;
+            tuned[f] = BOUNDS[f].lo < BOUNDS[f].hi;
+        }
+
+        Clock::time_point t1 = Clock::now();
+        double k = fitK(e, w, all);
+        double before = e.run(w, all, k, nullptr);
+        double passTime = seconds(t1) / 82; // fitK to 82 przebiegi
+        std::cout << "K " << std::setprecision(4) << k << ", error " << std::setprecision(6) << before << ", "
+            << std::setprecision(1) << d.size / std::max(passTime, 1e-9) / 1e6 << " M evaluations/s\n";
+
+        // MAN jest stały, więc skalę sigmoidy przejmuje K - po każdym dopasowaniu wag dobieramy je od nowa
+        for (int round = 1; round <= 3; ++round) {
+            std::cout << "round " << round << "\n";
+            optimize(e, w, all, tuned, k, iterations, rate);
+            k = fitK(e, w, all);
+            std::cout << "  K " << std::setprecision(4) << k << "\n";
+        }
+
+        double after = e.run(w, all, k, nullptr);
+        int rounded[eval::FEATURES];
+        for (int f = 0; f < eval::FEATURES; ++f) {
+            rounded[f] = int(std::lround(w[f]));
+            bool atBound = tuned[f] && (rounded[f] <= BOUNDS[f].lo || rounded[f] >= BOUNDS[f].hi);
+            std::cout << "  " << std::left << std::setw(10) << eval::FEATURE_NAMES[f] << std::right << std::setw(6)
+                << EVAL_WEIGHTS[f] << " -> " << std::setw(6) << rounded[f] << (atBound ? "  (at bound)" : "") << "\n";
+        }
+
+        std::ostringstream note;
+        note << d.size << " positions from " << std::filesystem::path(dataPath).filename().string() << ", K "
+            << std::fixed << std::setprecision(4) << k << ", error " << std::setprecision(6) << before << " -> " << after;
+        if (!writeHeader(outPath, rounded, source, note.str())) {
+            std::cerr << "cannot write " << outPath << "\n";
+            return 1;
+        }
+        std::cout << "error " << before << " -> " << after << ", wrote " << outPath << " in "
+            << std::setprecision(1) << seconds(t0) << " s\n";
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "extract") return runExtract(argc, argv);
+    if (command == "fit") return runFit(argc, argv);
+    std::cerr << "usage: tune extract [--skip N] [--out FILE] LOG...\n"
+                 "       tune fit [--data FILE] [--out FILE] [--threads N] [--iterations N] [--rate R] [--source TEXT]\n";
+    return 1;
+}